@@ -0,0 +1,94 @@
+//
+// bitboard.h
+//
+// 64-bit spot sets and the bit twiddling primitives used to query them
+//
+
+#pragma once
+
+#include <chessutil.h>
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+namespace chess {
+    /// One bit per board spot. Bit n is set for the spot at index n (col + row * 8)
+    using Bitboard = uint64_t;
+
+    static Bitboard const NoSpots = 0ull;
+    static Bitboard const AllSpots = ~0ull;
+
+    /// Get the Bitboard with only the bit for the specified spot set
+    inline Bitboard spotBit(unsigned int const ndx) { return Bitboard(1) << ndx; }
+
+    /// Get the number of spots set in a Bitboard
+    inline int popCount(Bitboard const bits) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(bits));
+#else
+        return __builtin_popcountll(bits);
+#endif
+    }
+
+    /// Get the index of the lowest spot set in a Bitboard. The Bitboard must not be empty.
+    inline unsigned int lsb(Bitboard const bits) {
+#if defined(_MSC_VER)
+        unsigned long ndx;
+        _BitScanForward64(&ndx, bits);
+        return static_cast<unsigned int>(ndx);
+#else
+        return static_cast<unsigned int>(__builtin_ctzll(bits));
+#endif
+    }
+
+    /// Remove the lowest spot set in a Bitboard and return its index
+    inline unsigned int popLsb(Bitboard &bits) {
+        unsigned int const ndx = lsb(bits);
+        bits &= bits - 1;
+        return ndx;
+    }
+
+    /**
+     * Get all of the spots a rook on the given spot attacks.  Uses the magic bitboard
+     * tables so the whole set comes from one multiply, shift and lookup.
+     *
+     * @param ndx The index of the spot the rook is on
+     * @param occupied All of the occupied spots on the board (either side)
+     * @return The attacked spots including the first occupied spot along each ray
+     */
+    Bitboard rookAttacks(unsigned int ndx, Bitboard occupied);
+
+    /**
+     * Get all of the spots a bishop on the given spot attacks.
+     *
+     * @param ndx The index of the spot the bishop is on
+     * @param occupied All of the occupied spots on the board (either side)
+     * @return The attacked spots including the first occupied spot along each ray
+     */
+    Bitboard bishopAttacks(unsigned int ndx, Bitboard occupied);
+
+    inline Bitboard queenAttacks(unsigned int const ndx, Bitboard const occupied) {
+        return rookAttacks(ndx, occupied) | bishopAttacks(ndx, occupied);
+    }
+
+    /// Get all of the spots a knight on the given spot attacks
+    Bitboard knightAttacks(unsigned int ndx);
+
+    /// Get all of the spots a king on the given spot attacks (not including castling)
+    Bitboard kingAttacks(unsigned int ndx);
+
+    /// Get the two (or one on the edge) spots a pawn of the given side on the given spot attacks
+    Bitboard pawnAttacks(Color side, unsigned int ndx);
+
+    /// Get the spots strictly between two spots on the same row, column or diagonal.
+    /// Returns NoSpots if the spots don't share a line or are next to each other.
+    Bitboard betweenSpots(unsigned int from, unsigned int to);
+
+    /// Get every spot on the row, column or diagonal running through two spots, edge to edge.
+    /// Returns NoSpots if the spots don't share a line.
+    Bitboard lineThrough(unsigned int from, unsigned int to);
+
+}  // namespace chess
@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include <bitboard.h>
 #include <chessutil.h>
 #include <move.h>
+#include <zobrist.h>
 
 #include <array>
 #include <cmath>
@@ -16,18 +18,47 @@ namespace chess {
     using std::array;
     using std::vector;
 
+    /// The parts of the board state that Board::executeMove(...) changes and that can't be
+    /// worked out again from the Move itself.  Used by Board::undoMove(...) to take a move back.
+    struct MoveUndo {
+        Piece moved{Empty};           // the moving piece as it was before the move
+        Piece captured{Empty};        // the captured piece (if any)
+        unsigned int capturedNdx{};   // the spot of the captured piece (differs for en passant)
+        Piece rook{Empty};            // the castling rook as it was before the move (if any)
+        unsigned int rookNdx{};       // the spot the castling rook moved from
+        unsigned int turns{};
+        Color turn{White};
+    };
+
     class Board {
     private:
     public:
         array<Piece, BOARD_SIZE> board{};
-        MoveList moves1;
-        MoveList moves2;
+
+        /// the move lists as last generated.  advanceTurn() and generateMoveLists() fill both
+        /// right away, nextTurn() leaves them for getMoves1() and getMoves2() to fill on demand
+        mutable MoveList moves1;
+        mutable MoveList moves2;
+        mutable bool moves1Ready{false};
+        mutable bool moves2Ready{false};
+
         PieceList taken1;
         PieceList taken2;
-        MoveList history;
+        MoveHistory history;
+        vector<HashKey> hashHistory;  // getHash() of the position before each move in history
         unsigned int ndxKing1{};
         unsigned int ndxKing2{};
 
+        /// occupancy bitboards kept in step with the board array.
+        /// pieceBits is indexed by piece type and sideBits is indexed by Color
+        array<Bitboard, 8> pieceBits{};
+        array<Bitboard, 2> sideBits{};
+
+        /// Zobrist hash of the pieces, castling rights and en passant column kept up to date
+        /// by setSpot(...), setMoved(...), executeMove(...) and undoMove(...).  The side to
+        /// move is added by getHash() so changing .turn directly never leaves it stale
+        HashKey hash{};
+
         int maxRep{3};
         unsigned int turns{};
         unsigned int turn{White};
@@ -49,6 +80,48 @@ namespace chess {
         void setMoved(unsigned int ndx, bool hasMoved);
         void setCheck(unsigned int ndx, bool inCheck);
         void setPromoted(unsigned int ndx, bool promoted);
+
+        /**
+         * Place a piece (or Empty) on a spot and keep the bitboards up to date
+         *
+         * @param ndx The index of the spot to set
+         * @param piece The piece value to place on the spot
+         */
+        void setSpot(unsigned int ndx, Piece piece);
+
+        /**
+         * Rebuild all of the bitboards and the hash from the board array.  Only needed after
+         * the board array has been written to directly instead of through setSpot(...)
+         */
+        void updateBitboards();
+
+        /// Get the 64-bit Zobrist hash of the position including the side to move
+        [[nodiscard]] HashKey getHash() const { return (turn == White) ? hash ^ sideKey() : hash; }
+
+        /// Work out the hash (without the side to move) from scratch
+        [[nodiscard]] HashKey computeHash() const;
+
+        /// Get the castling rights (WhiteKingSide etc.) left judging by the unmoved kings and rooks
+        [[nodiscard]] unsigned int getCastleRights() const;
+
+        /// Get the column a pawn can be captured en passant on or NoEnPassant
+        [[nodiscard]] unsigned int getEnPassantCol() const;
+
+        /// Get the number of times the current position came up earlier in the game
+        [[nodiscard]] int countRepetitions() const;
+
+        [[nodiscard]] Bitboard getPieces(Piece type) const { return pieceBits[type]; }
+        [[nodiscard]] Bitboard getPieces(Color side, Piece type) const {
+            return pieceBits[type] & sideBits[side];
+        }
+        [[nodiscard]] Bitboard getOccupied(Color side) const { return sideBits[side]; }
+
+        /// Get the spots of a side's knights, bishops, rooks and queens
+        [[nodiscard]] Bitboard getNonPawnPieces(Color side) const {
+            return sideBits[side] & ~(pieceBits[Pawn] | pieceBits[King]);
+        }
+        [[nodiscard]] Bitboard getOccupied() const { return sideBits[White] | sideBits[Black]; }
+
         static vector<string> to_string(Board const& b);
 
         [[nodiscard]] Move lastMove() const { return history.empty() ? Move() : history.back(); }
@@ -57,9 +130,41 @@ namespace chess {
 
         [[nodiscard]] bool checkDrawByRepetition(Move const& move, int limit = -1) const;
 
+        [[nodiscard]] bool isSquareAttacked(unsigned int ndx, Color bySide) const;
+
+        [[nodiscard]] Bitboard attackersTo(unsigned int ndx, Bitboard occupied) const;
+
+        /**
+         * Static exchange evaluation: work out what a capture wins or loses once both sides
+         * have made every capture on its spot that pays, least valuable attacker first.
+         * Sliders lined up behind an attacker (x-rays) join in as the pieces in front go.
+         * A king only captures if nothing can take it back.  Pins are not considered.
+         *
+         * @param move The move to evaluate (a move to an empty spot captures nothing)
+         * @return The material the side making the move ends up ahead, in pieceValues
+         */
+        [[nodiscard]] int see(Move const& move) const;
+
+        [[nodiscard]] Bitboard getPinned(Color side, unsigned int ndx) const;
+
         [[nodiscard]] bool kingIsInCheck(Color side) const;
 
-        void executeMove(Move& move);
+        MoveUndo executeMove(Move& move);
+
+        void undoMove(Move const& move, MoveUndo const& undo);
+
+        /**
+         * Pass instead of moving (a null move) as a search does to see if the position is
+         * still good enough without spending a move.  An empty Move goes into the history so
+         * en passant is lost and repetitions count as usual.  Like executeMove(...) the turn
+         * is left for nextTurn() to change.
+         *
+         * @return What undoNullMove(...) needs to take the null move back
+         */
+        MoveUndo executeNullMove();
+
+        /// Take back a null move made with executeNullMove()
+        void undoNullMove(MoveUndo const& undo);
 
         /**
          * Advance the total number of moves in the game.
@@ -79,18 +184,43 @@ namespace chess {
          */
         void advanceTurn();
 
-        [[nodiscard]] MoveList getMoves(Color side, bool checkKing) const;
+        /**
+         * Advance the total number of moves in the game and toggle which players turn it is
+         * without generating either move list.  getMoves1() and getMoves2() generate them the
+         * first time they are asked for so a search only pays for the lists it looks at.
+         */
+        void nextTurn();
+
+        /// Get the moves for the side whose turn it is (moves1), generating them if needed
+        [[nodiscard]] MoveList const& getMoves1() const;
+
+        /// Get the moves for the side whose turn it isn't (moves2), generating them if needed
+        [[nodiscard]] MoveList const& getMoves2() const;
+
+        [[nodiscard]] MoveList getMoves(Color side, bool checkKing,
+                                        Bitboard targets = AllSpots) const;
         [[nodiscard]] MoveList getMovesSorted(Color side) const;
+        [[nodiscard]] MoveList getLegalMoves(Color side, Bitboard targets = AllSpots,
+                                             bool firstOnly = false) const;
+
+        /// See if a side has any legal move at all, stopping at the first one found
+        [[nodiscard]] bool hasLegalMove(Color side) const;
+
+        [[nodiscard]] unsigned int getTargetSpot(Move const& move) const;
 
         MoveList cleanupMoves(MoveList& moves, Color side) const;
 
+        [[nodiscard]] bool leavesKingSafe(Move const& move, Color side) const;
+
+        void addPieceMoves(MoveList& moves, unsigned int ndx, Bitboard allowed) const;
+
         static bool isValidSpot(unsigned int col, unsigned int row);
 
         void addMoveIfValid(MoveList& moves, unsigned int fromCol, unsigned int fromRow,
                             unsigned int toCol, unsigned int toRow) const;
 
-        [[nodiscard]] bool addSlider(MoveList& moves, unsigned int col, unsigned int row,
-                                     unsigned int x, unsigned int y) const;
+        void addMoves(MoveList& moves, unsigned int col, unsigned int row,
+                      Bitboard targets) const;
 
         /**
          * Get a list of all possible moves for a pawn at the given location on the board.
@@ -107,40 +237,48 @@ namespace chess {
          *
          * @param col The column on the board to get moves from
          * @param row The row on the board to get moves from
+         * @param allowed The spots the rook may move to (used for pins and checks)
          * @return A new vector<Move> containing all possible moves a rook could make from the given
          * spot
          */
-        void getRookMoves(MoveList& moves, unsigned int col, unsigned int row) const;
+        void getRookMoves(MoveList& moves, unsigned int col, unsigned int row,
+                          Bitboard allowed = AllSpots) const;
 
         /**
          * Get a list of all possible moves for a knight at the given location on the board.
          *
          * @param col The column on the board to get moves from
          * @param row The row on the board to get moves from
+         * @param allowed The spots the knight may move to (used for pins and checks)
          * @return A new vector<Move> containing all possible moves a knight could make from the
          * given spot
          */
-        void getKnightMoves(MoveList& moves, unsigned int col, unsigned int row) const;
+        void getKnightMoves(MoveList& moves, unsigned int col, unsigned int row,
+                            Bitboard allowed = AllSpots) const;
 
         /**
          * Get a list of all possible moves for a bishop at the given location on the board.
          *
          * @param col The column on the board to get moves from
          * @param row The row on the board to get moves from
+         * @param allowed The spots the bishop may move to (used for pins and checks)
          * @return A new vector<Move> containing all possible moves a bishop could make from the
          * given spot
          */
-        void getBishopMoves(MoveList& moves, unsigned int col, unsigned int row) const;
+        void getBishopMoves(MoveList& moves, unsigned int col, unsigned int row,
+                            Bitboard allowed = AllSpots) const;
 
         /**
          * Get a list of all possible moves for a queen at the given location on the board.
          *
          * @param col The column on the board to get moves from
          * @param row The row on the board to get moves from
+         * @param allowed The spots the queen may move to (used for pins and checks)
          * @return A new vector<Move> containing all possible moves a queen could make from the
          * given spot
          */
-        void getQueenMoves(MoveList& moves, unsigned int col, unsigned int row) const;
+        void getQueenMoves(MoveList& moves, unsigned int col, unsigned int row,
+                           Bitboard allowed = AllSpots) const;
 
         /**
          * Get a list of all possible moves for a king at the given location on the board.
@@ -0,0 +1,97 @@
+//
+// fixedlist.h
+//
+// a list with a fixed capacity that keeps its items inline instead of on the heap
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace chess {
+    /**
+     * A list with room for up to Capacity items stored inside the object itself so creating,
+     * filling and copying one never touches the heap.  Only the items in use are copied.
+     * Supports the parts of the std::vector interface the move lists need.  Items added past
+     * the capacity are dropped.
+     */
+    template <typename T, unsigned int Capacity> class FixedList {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "FixedList items are copied as plain memory");
+
+    private:
+        unsigned int count{0};
+        union {
+            T items[Capacity];
+        };
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = T const &;
+        using iterator = T *;
+        using const_iterator = T const *;
+
+        FixedList() {}
+
+        FixedList(FixedList const &ref) : count(ref.count) {
+            std::uninitialized_copy(ref.begin(), ref.end(), begin());
+        }
+
+        FixedList &operator=(FixedList const &ref) {
+            if (this != &ref) {
+                count = ref.count;
+                std::uninitialized_copy(ref.begin(), ref.end(), begin());
+            }
+            return *this;
+        }
+
+        [[nodiscard]] size_t size() const { return count; }
+        [[nodiscard]] bool empty() const { return count == 0; }
+        [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+
+        iterator begin() { return items; }
+        iterator end() { return items + count; }
+        const_iterator begin() const { return items; }
+        const_iterator end() const { return items + count; }
+        const_iterator cbegin() const { return items; }
+        const_iterator cend() const { return items + count; }
+
+        reference operator[](size_t const ndx) { return items[ndx]; }
+        const_reference operator[](size_t const ndx) const { return items[ndx]; }
+        reference front() { return items[0]; }
+        const_reference front() const { return items[0]; }
+        reference back() { return items[count - 1]; }
+        const_reference back() const { return items[count - 1]; }
+
+        void clear() { count = 0; }
+
+        void push_back(T const &item) {
+            if (count < Capacity) {
+                new (&items[count++]) T(item);
+            }
+        }
+
+        template <typename... Args> void emplace_back(Args &&... args) {
+            if (count < Capacity) {
+                new (&items[count++]) T(std::forward<Args>(args)...);
+            }
+        }
+
+        void pop_back() { --count; }
+
+        /// Remove the items in [first, last) and slide the ones after them down
+        iterator erase(const_iterator first, const_iterator last) {
+            iterator const pos = begin() + (first - begin());
+            iterator const next = std::copy(begin() + (last - begin()), end(), pos);
+            count = static_cast<unsigned int>(next - begin());
+            return pos;
+        }
+    };
+
+}  // namespace chess
@@ -0,0 +1,64 @@
+//
+// heuristics.h
+//
+// what caused beta cutoffs earlier in a search (killer moves and the history heuristic),
+// used to guess which quiet moves are worth searching first
+//
+
+#pragma once
+
+#include <chessutil.h>
+#include <move.h>
+
+#include <array>
+
+namespace chess {
+    using std::array;
+
+    class SearchHeuristics {
+    public:
+        /// The number of plies killer moves are kept for
+        static unsigned const MaxPly = 64u;
+
+        /// The number of killer moves kept for each ply
+        static unsigned const NumKillers = 2u;
+
+        /// Quiet move scores: killers come ahead of any history score
+        static int const KillerScore = 1 << 30;
+        static int const HistoryMax = 1 << 20;
+
+    private:
+        array<array<PackedMove, NumKillers>, MaxPly> killers{};
+
+        /// the butterfly table: cutoff counts by side and the move's from and to spots
+        array<array<array<int, BOARD_SIZE>, BOARD_SIZE>, 2> history{};
+
+    public:
+        /// search statistics: beta cutoffs and how many of them the first move searched made
+        long cutoffs{0};
+        long firstMoveCutoffs{0};
+
+        /// Forget all of the killer moves, history and statistics
+        void clear();
+
+        /**
+         * Note a beta cutoff.  A quiet move becomes the newest killer move for its ply and
+         * gains depth * depth in the history table.  Captures and promotions are left to
+         * the capture ordering but still count in the statistics.
+         *
+         * @param side The side that made the move
+         * @param move The move that caused the cutoff
+         * @param ply The number of plies from the root the move was made at
+         * @param depth The depth left to search when the move was made
+         * @param moveNumber The move's place in the ordering, starting at 1
+         */
+        void addCutoff(Color side, Move const &move, size_t ply, int depth, int moveNumber);
+
+        /// Get the score to order a quiet move by, higher first
+        [[nodiscard]] int score(Color side, Move const &move, size_t ply) const;
+
+        /// Get the killer moves for a ply, newest first (empty moves if there are none)
+        [[nodiscard]] array<PackedMove, NumKillers> const &getKillers(size_t ply) const;
+    };
+
+}  // namespace chess
@@ -9,34 +9,108 @@
 #include <bestmove.h>
 #include <board.h>
 #include <move.h>
-#include <movecache.h>
+#include <movepicker.h>
+#include <threadpool.h>
+#include <transposition.h>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
 
 namespace chess {
+    using std::array;
+    using std::atomic;
     using std::mutex;
     using std::chrono::steady_clock;
 
+    struct SplitPoint;
+
     class Minimax {
     public:
+        /// With useSee, losing captures are pruned off the principal variation this near the
+        /// search depth
+        static int const SeePruneDepth = 3;
+
+        /// With useQuiescence, a capture that would leave the score this far short of alpha
+        /// even if the piece were won for nothing isn't searched (delta pruning).  In
+        /// Evaluator::evaluate(...) terms, where a pawn is worth 100.
+        static int const DeltaMargin = 200;
+
+        /// With useFutility, frontier nodes (this near the search depth) off the principal
+        /// variation are pruned by how far their evaluation is from the window
+        static int const FutilityDepth = 2;
+
+        /// With useYbwc, boards searched this deep or deeper can be split between threads
+        static int const SplitDepth = 2;
+
+        /// What negamax(...) works out about a board that decides how its moves are searched
+        struct SearchNode {
+            int depth;        // the depth left to search
+            bool inCheck;     // the side to move is in check (only worked out when needed)
+            bool nullWindow;  // the board is off the principal variation
+            bool futile;      // quiet moves can't lift the board to alpha (useFutility)
+        };
+
+        /// How negamaxMove(...) dealt with a move
+        enum class MoveOutcome {
+            Pruned,    // skipped without being searched
+            Searched,  // searched and taken back
+            Mate       // it leaves the other side no moves
+        };
+
+        /// One thread's count of the moves it examined, on a cache line of its own so the
+        /// threads of a search never lock or write over each other to count
+        struct alignas(64) NodeCount {
+            atomic<long> nodes{0};
+        };
+
         steady_clock::time_point startTime;  // the time the current move search started
-        int movesExamined;  // the number of possible moves examined so far during this move search
+        int movesExamined;  // the number of possible moves examined during the last move search
+        array<NodeCount, ThreadPool::MaxThreads + 1> nodeCounts;  // by ThreadPool::threadSlot()
         bool extraChecks;   // perform extra checks on each move y/N
-        unsigned reserve;   // the number of cpu cores to keep out of thread pool during
-                            // multi-threaded move searches
+        unsigned reserve;   // the number of cpu cores to leave idle during multi-threaded
+                            // move searches when numThreads is 0
         bool useThreads;    // use multi-threaded move search y/N
+        bool useSharedWindow;  // root move threads narrow a shared window by their scores y/N
+        bool useLazySmp;    // search the root on every core at once, sharing only the cache y/N
+        bool useYbwc;  // split negamax boards between threads once one move is searched y/N
+        unsigned numThreads;  // the threads a parallel search uses, 0 for one per core
         int qMaxDepth;      // the maximum depth for quiescent searches
-        bool useCache;      // use move cache y/N
-        double
-            acceptableRiskLevel;  // the maximum risk level allowed for cache moves to be used 0.0
-                                  // - 1.0. default: 0.0 - 0.25
+        bool useCache;      // use the transposition table y/N
+        bool useMovePicker;  // generate and pick moves in stages during the search y/N
+        int cacheSize;       // the size of the transposition table in megabytes
+        bool useIterativeDeepening;  // search 1 ply deeper at a time up to maxDepth y/N
+        bool useNegamax;  // search with negamax and principal variation search instead of minmax
+        bool useAspiration;    // search the root in a window around the expected score y/N
+        bool useNullMove;       // prune with null moves in negamax's null window searches y/N
+        int nullMoveReduction;  // how many plies shallower than usual a null move is searched
+        bool useLateMoveReductions;  // search quiet moves late in the ordering shallower y/N
+        bool useKillers;  // order quiet moves by killer moves and the history heuristic y/N
+        bool useSee;  // order (with useMovePicker) and prune captures by static exchange y/N
+        bool useQuiescence;     // search only captures and promotions past the search depth y/N
+        bool quiescenceChecks;  // also search quiet checks on the first quiescent ply y/N
+        bool useFutility;  // prune frontier nodes by their evaluation (futility, razoring) y/N
+        int futilityMargin;         // per ply: skip quiet moves this far below alpha
+        int reverseFutilityMargin;  // per ply: cut off this far above beta
+        int razorMargin;            // per ply: drop into the quiescence search this far below alpha
+        long cutoffs;           // the number of beta cutoffs in all searches so far
+        long firstMoveCutoffs;  // the number of those made by the first move searched
+        int aspirationWindow;  // half the width of the first aspiration window
+        int failHighs;  // the number of aspiration windows the root score came in above
+        int failLows;   // the number of aspiration windows the root score came in below
+        array<int, 2> lastValue;       // the value each side's last search found
+        array<size_t, 2> lastHistory;  // the board history length at each side's last search
+        array<bool, 2> lastValid;      // each side's last search found a best move y/N
         BestMove best{true};      // the best move found so far during the current best move search
-        MoveCache cache;          // cache of computed moves for board arrangements we've seen
+        TranspositionTable cache;  // results of searching board positions we've seen
         int maxDepth;  // the maximum depth of move responses to consider during best move search
         int timeout;   // the number of seconds allowed for computer to make a move. 0 means no time
                        // limit.
+        MoveList pv;        // the principal variation (root move first) of the last search.
+                            // Iterative deepening tries it first in the next iteration
+        size_t rootHistory;  // the length of the board history at the root of the search
 
         explicit Minimax(int max_depth = 0);
 
@@ -46,29 +120,175 @@ namespace chess {
             extraChecks = ref.extraChecks;
             reserve = ref.reserve;
             useThreads = ref.useThreads;
+            useSharedWindow = ref.useSharedWindow;
+            useLazySmp = ref.useLazySmp;
+            useYbwc = ref.useYbwc;
+            numThreads = ref.numThreads;
             qMaxDepth = ref.qMaxDepth;
             useCache = ref.useCache;
+            useMovePicker = ref.useMovePicker;
+            useIterativeDeepening = ref.useIterativeDeepening;
+            useNegamax = ref.useNegamax;
+            useAspiration = ref.useAspiration;
+            useNullMove = ref.useNullMove;
+            nullMoveReduction = ref.nullMoveReduction;
+            useLateMoveReductions = ref.useLateMoveReductions;
+            useKillers = ref.useKillers;
+            useSee = ref.useSee;
+            useQuiescence = ref.useQuiescence;
+            quiescenceChecks = ref.quiescenceChecks;
+            useFutility = ref.useFutility;
+            futilityMargin = ref.futilityMargin;
+            reverseFutilityMargin = ref.reverseFutilityMargin;
+            razorMargin = ref.razorMargin;
+            cutoffs = ref.cutoffs;
+            firstMoveCutoffs = ref.firstMoveCutoffs;
+            aspirationWindow = ref.aspirationWindow;
+            failHighs = ref.failHighs;
+            failLows = ref.failLows;
+            lastValue = ref.lastValue;
+            lastHistory = ref.lastHistory;
+            lastValid = ref.lastValid;
             best = ref.best;
-            cache.cache = ref.cache.cache;
+            cacheSize = ref.cacheSize;
+            cache = ref.cache;
             maxDepth = ref.maxDepth;
             timeout = ref.timeout;
-            acceptableRiskLevel = ref.acceptableRiskLevel;
+            pv = ref.pv;
+            rootHistory = ref.rootHistory;
         }
 
         Move bestMove(Board const &board);
 
+        /// Get the number of moves examined so far in the current move search, added up over
+        /// all of its threads.  Once bestMove(...) returns it is exact and in movesExamined.
+        [[nodiscard]] long countNodes() const;
+
+        /**
+         * Get how many plies shallower to search a quiet move at the given point in the move
+         * ordering (useLateMoveReductions).  The reductions are worked out once into a depth
+         * by move number table and grow with the log of both.
+         *
+         * @param depth the depth left to search at the board the move is made on
+         * @param moveNumber the move's place in the ordering, starting at 1
+         * @return the number of plies to reduce the move's search by
+         */
+        static int lateMoveReduction(int depth, int moveNumber);
+
         /**
          * Iterate over all available moves for the current player and decide which move is the
          * best. This executes on the current thread and is a blocking call.
          *
          * @param board the board state to examine each move on
+         * @param moves the moves to examine, in the order to examine them
+         * @param pieceMap board pieces mapped by type and side
+         * @param alpha the lowest white-positive score the search is looking for
+         * @param beta the highest white-positive score the search is looking for
+         * @return the best move for this board.  Its principal variation is left in pv
+         */
+        Move searchWithNoThreads(Board const &board, MoveList const &moves, bool maximize,
+                                 PieceMap &pieceMap, int alpha = MIN_VALUE,
+                                 int beta = MAX_VALUE);
+
+        /**
+         * Search the root moves on the shared ThreadPool with numThreads tasks (or one per
+         * core less reserve if numThreads is 0), each taking the next move left until there
+         * are none.  Every move is searched with the same window and the results are taken
+         * in the order of moves.
+         *
+         * With useSharedWindow the threads share the window: each root move's score narrows
+         * it to the scores that could still tie or beat that move, and the other threads
+         * pick that up at every board they search.  Boards that can no longer change their
+         * root move's score are cut off.  The best move and score come out the same.
+         *
+         * @param board the board state to examine each move on
+         * @param moves the moves to examine, in the order to examine them
+         * @param maximize true if it is white's turn
          * @param pieceMap board pieces mapped by type and side
+         * @param alpha the lowest white-positive score the search is looking for
+         * @param beta the highest white-positive score the search is looking for
+         * @return the best move for this board.  Its principal variation is left in pv
+         */
+        Move searchWithThreads(Board const &board, MoveList const &moves, bool maximize,
+                               PieceMap &pieceMap, int alpha = MIN_VALUE, int beta = MAX_VALUE);
+
+        /**
+         * Lazy SMP: search the root on this thread as searchWithNoThreads(...) does while
+         * helpers on the shared ThreadPool search the same root, numThreads threads in all
+         * (as for searchWithThreads(...)) counting this one.  The helpers vary the search so
+         * they don't all repeat each other: every other one goes a ply deeper and each starts
+         * on a different root move.  They only help through what they leave in the
+         * transposition table so useCache should be on.  Their results are thrown away and
+         * they are stopped as soon as this thread's search is done.
+         *
+         * @param board the board state to examine each move on
+         * @param moves the moves to examine, in the order to examine them
+         * @param maximize true if it is white's turn
+         * @param pieceMap board pieces mapped by type and side
+         * @param alpha the lowest white-positive score the search is looking for
+         * @param beta the highest white-positive score the search is looking for
+         * @return the best move this thread found.  Its principal variation is left in pv
+         */
+        Move searchLazySmp(Board const &board, MoveList const &moves, bool maximize,
+                           PieceMap &pieceMap, int alpha = MIN_VALUE, int beta = MAX_VALUE);
+
+        /**
+         * Young Brothers Wait: search the root on this thread as searchWithNoThreads(...)
+         * does with helpers on the shared ThreadPool (numThreads in all, as for
+         * searchLazySmp(...)) standing by.  Once negamax(...) has searched the first move of
+         * a board at least SplitDepth deep, and some helper is idle, the rest of the board's
+         * moves become a split point every idle helper can join.  The threads at a split
+         * point share its alpha and best score, and a cutoff by any of them stops the others
+         * (and everything they split off below it).  Only negamax(...) splits, so
+         * useNegamax should be on.
+         *
+         * @param board the board state to examine each move on
+         * @param moves the moves to examine, in the order to examine them
+         * @param maximize true if it is white's turn
+         * @param pieceMap board pieces mapped by type and side
+         * @param alpha the lowest white-positive score the search is looking for
+         * @param beta the highest white-positive score the search is looking for
+         * @return the best move for this board.  Its principal variation is left in pv
+         */
+        Move searchYbwc(Board const &board, MoveList const &moves, bool maximize,
+                        PieceMap &pieceMap, int alpha = MIN_VALUE, int beta = MAX_VALUE);
+
+        /**
+         * Search the moves left at a split point with the threads already searching them
+         * until there are none left or one of the threads makes a cutoff (useYbwc)
+         *
+         * @param split the split point to help search
+         */
+        void searchSplit(SplitPoint &split);
+
+        /**
+         * Search the root moves with or without threads.  With useAspiration and an expected
+         * score the search starts in a window of aspirationWindow either side of it.  When the
+         * score lands outside the window that side is widened, twice as far each time, and
+         * the moves searched again.  The window is in white-positive terms like the scores.
+         *
+         * @param board the board state to examine each move on
+         * @param moves the moves to examine, in the order to examine them
+         * @param maximize true if it is white's turn
+         * @param pieceMap board pieces mapped by type and side
+         * @param expected the score the search is expected to find
+         * @param hasExpected false to search with the full window
          * @return the best move for this board
          */
-        Move searchWithNoThreads(Board const &board, bool maximize, PieceMap &pieceMap);
+        Move searchRoot(Board const &board, MoveList const &moves, bool maximize,
+                        PieceMap &pieceMap, int expected, bool hasExpected);
 
-        // Search With threads
-        Move searchWithThreads(Board const &board, bool maximize, PieceMap &pieceMap);
+        /**
+         * Search to 1 ply, then 2 and so on up to maxDepth, stopping early if the time runs
+         * out.  Each iteration searches the previous one's best move and principal variation
+         * first.  An iteration cut short by the timeout is thrown away.
+         *
+         * @param board the board state to examine each move on
+         * @param maximize true if it is white's turn
+         * @param pieceMap board pieces mapped by type and side
+         * @return the best move of the last iteration that completed
+         */
+        Move searchIteratively(Board const &board, bool maximize, PieceMap &pieceMap);
 
         /**
          * The awesome, one and only, minimax algorithm method which recursively searches
@@ -85,26 +305,73 @@ namespace chess {
          * @param maximize  true if we are looking for a board state with the maximum score (white
          * player's turn) false if we are looking for a board state with the lowest score (black
          * player's turn)
+         * @param line      if not nullptr, set to the best line of play found from here
          * @return the best score this move (and all consequential response/exchanges up to the
          * allowed look-ahead depth or time limit for searching).
          */
-        int minmax(Board &origBoard, int alpha, int beta, int depth, bool maximize);
-    };
+        int minmax(Board &origBoard, int alpha, int beta, int depth, bool maximize,
+                   MoveList *line = nullptr);
+
+        /**
+         * The same search as minmax(...) written as negamax with principal variation search.
+         * Scores are from the point of view of the side to move so one branch serves both
+         * sides.  The first move is searched with the full alpha/beta window and the rest
+         * with a null window that only proves they are no better, searching again with the
+         * full window when one turns out to be.
+         *
+         * @param origBoard the board state to examine all moves for
+         * @param alpha     the lower bound of the score for the side to move
+         * @param beta      the upper bound of the score for the side to move
+         * @param depth     the number of plies to search ahead
+         * @param line      if not nullptr, set to the best line of play found from here
+         * @param allowNullMove false to not try a null move here (useNullMove)
+         * @return the best score for the side to move
+         */
+        int negamax(Board &origBoard, int alpha, int beta, int depth, MoveList *line = nullptr,
+                    bool allowNullMove = true);
 
-    struct ThreadArgs {
-        Board const &board;
-        Move const &move;
-        Minimax &agent;
-        int depth;
-        bool maximize;
+        /**
+         * Search one of a negamax(...) board's moves: prune it if the board's pruning
+         * allows, or else make it, search it and take it back.  The first move gets the full
+         * window and the rest a (possibly reduced) null window, searched again if they beat
+         * alpha.
+         *
+         * @param board      the board the move is made on, left as it was
+         * @param move       the move to search
+         * @param alpha      the lower bound of the score for the side to move
+         * @param beta       the upper bound of the score for the side to move
+         * @param moveNumber the move's place among the board's searched moves, starting at 1
+         * @param node       what negamax(...) worked out about the board
+         * @param value      set to the move's score for the side to move unless it is pruned
+         * @param line       if not nullptr, set to the best line of play after the move
+         * @return how the move was dealt with
+         */
+        MoveOutcome negamaxMove(Board &board, Move &move, int alpha, int beta, int moveNumber,
+                                SearchNode const &node, int &value, MoveList *line);
 
-        ThreadArgs() = delete;
-        ThreadArgs(Board const &b, Move const &m, Minimax &mm, int d, bool max);
+        /**
+         * The quiescence search minmax(...) and negamax(...) hand off to past the search depth
+         * with useQuiescence, so a board is never scored in the middle of an exchange.  The
+         * side to move can stand pat on the board's evaluation or try its captures and
+         * promotions (and quiet checks on the first ply with quiescenceChecks), most valuable
+         * victim first.  Captures that can't raise the score to alpha (delta pruning) or,
+         * with useSee, that lose material are skipped.  In check every move is searched.
+         *
+         * @param origBoard the board state to examine
+         * @param alpha     the lower bound of the score for the side to move
+         * @param beta      the upper bound of the score for the side to move
+         * @param qply      the number of plies past the search depth
+         * @return the score for the side to move
+         */
+        int quiesce(Board &origBoard, int alpha, int beta, int qply = 0);
     };
 
     struct ThreadResult {
         int value;
         Move move;
+        MoveList line;  // the best line of play after move
+        long cutoffs{0};  // the beta cutoffs the thread's search made
+        long firstMoveCutoffs{0};
 
         ThreadResult();
         ThreadResult(int i, Move const &m);
@@ -4,25 +4,70 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 
 using std::string;
 
+// MoveList iterators are plain pointers so argument dependent lookup
+// won't find the std algorithms for them
+using std::find;
+using std::sort;
+
 #include <chessutil.h>
+#include <fixedlist.h>
 
 namespace chess {
     class Board;
 
-    class Move;
+    /**
+     * A move packed into 16 bits: the from and to spots, the flag saying what kind of
+     * move it is and, for promotions, the piece the pawn becomes.  Small enough to keep
+     * in move history, cache entries and tables without the score that only the move
+     * lists need.
+     *
+     *   bits  0 -  5 : from spot index (col + row * 8)
+     *   bits  6 - 11 : to spot index
+     *   bits 12 - 13 : promotion piece (Knight, Bishop, Rook or Queen) less Knight
+     *   bits 14 - 15 : move flag
+     */
+    class PackedMove {
+    private:
+        uint16_t bits{0};
+
+    public:
+        /// Move Flags
+        static unsigned const Normal = 0u;
+        static unsigned const Promotion = 1u;
+        static unsigned const EnPassant = 2u;
+        static unsigned const Castle = 3u;
+
+        PackedMove() = default;
+
+        explicit PackedMove(uint16_t bits) : bits(bits) {}
+
+        PackedMove(unsigned int from, unsigned int to, unsigned int flag = Normal,
+                   Piece promotion = Queen);
+
+        [[nodiscard]] unsigned int getFrom() const { return bits & 0x3Fu; }
+        [[nodiscard]] unsigned int getTo() const { return (bits >> 6u) & 0x3Fu; }
+        [[nodiscard]] unsigned int getFlag() const { return (bits >> 14u) & 0x3u; }
+        [[nodiscard]] Piece getPromotion() const { return Knight + ((bits >> 12u) & 0x3u); }
+        [[nodiscard]] uint16_t getBits() const { return bits; }
+
+        bool operator==(PackedMove const &move) const { return bits == move.bits; }
+        bool operator!=(PackedMove const &move) const { return bits != move.bits; }
+    };
+
+    /**
+     * A PackedMove along with the score the move generator or search gave it and the
+     * piece it captured (once it has been made).  This is what the move lists hold.
+     */
     class Move {
     private:
-        Piece captured;
-        unsigned int fromCol;
-        unsigned int fromRow;
-        unsigned int toCol;
-        unsigned int toRow;
-        unsigned int from;
-        unsigned int to;
+        PackedMove packed;
+        uint8_t captured;
         int value;
 
     public:
@@ -31,6 +76,8 @@ namespace chess {
         Move(unsigned int fromCol, unsigned int fromRow, unsigned int toCol, unsigned int toRow,
              int value);
 
+        explicit Move(PackedMove packed, int value = 0);
+
         Move(Move const &ref) = default;
 
         Move &operator=(Move const &ref) = default;
@@ -55,10 +102,24 @@ namespace chess {
 
         [[nodiscard]] bool isCapture() const;
 
+        [[nodiscard]] PackedMove getPacked() const { return packed; }
+
+        [[nodiscard]] unsigned int getFlag() const { return packed.getFlag(); }
+
+        [[nodiscard]] bool isPromotion() const { return getFlag() == PackedMove::Promotion; }
+
+        [[nodiscard]] bool isEnPassant() const { return getFlag() == PackedMove::EnPassant; }
+
+        [[nodiscard]] bool isCastle() const { return getFlag() == PackedMove::Castle; }
+
+        [[nodiscard]] Piece getPromotion() const { return packed.getPromotion(); }
+
         void setValue(int value);
 
         void setCaptured(Piece p);
 
+        void setFlag(unsigned int flag, Piece promotion = Queen);
+
         [[nodiscard]] bool isValid() const;
 
         [[nodiscard]] bool isValid(Board const &board) const;
@@ -66,6 +127,15 @@ namespace chess {
         [[nodiscard]] string to_string(unsigned int flag = 0b111u) const;
     };
 
-    using MoveList = vector<Move>;
+    static_assert(sizeof(PackedMove) == 2, "PackedMove should fit in 16 bits");
+    static_assert(sizeof(Move) == 8, "Move should fit in 64 bits");
+
+    /// Room for every move one side can have in any position (legal chess needs 218 at most)
+    static unsigned const MAX_MOVES = 320u;
+
+    using MoveList = FixedList<Move, MAX_MOVES>;
+
+    /// The moves made so far in a game which, unlike a MoveList, can grow without limit
+    using MoveHistory = vector<Move>;
 
 }  // namespace chess
@@ -0,0 +1,95 @@
+//
+// movepicker.h
+//
+// hands out the moves for a board one at a time, best guesses first, generating them in
+// stages so a search that cuts off early never pays for the moves it didn't look at
+//
+
+#pragma once
+
+#include <board.h>
+#include <heuristics.h>
+#include <move.h>
+
+namespace chess {
+    class MovePicker {
+    private:
+        /// The stages a staged picker steps through, in order
+        enum class Stage {
+            HashMove,
+            GenerateCaptures,
+            Captures,
+            GenerateQuiets,
+            Quiets,
+            BadCaptures,
+            Done
+        };
+
+        Board const *board;  // the board to pick moves for or nullptr when walking a list
+        Color side;
+        Move hashMove;
+        Stage stage;
+        MoveList moves;
+        size_t current;
+        SearchHeuristics const *heuristics;  // orders the quiet moves or nullptr to leave them
+        size_t ply;                          // plies from the root, for the killer moves
+        bool useSee;                         // hold back captures that lose material y/N
+        MoveList badCaptures;                // the captures held back until the end
+
+        /// Put the moves from first on in order by their heuristics scores, best first
+        void orderQuiets(size_t first);
+
+    public:
+        /**
+         * Pick the moves for the side to move on a board in stages:
+         *
+         *      + the hash move (if it is legal here)
+         *      + captures, most valuable victim first then least valuable attacker
+         *      + the remaining (quiet) moves in the order they were generated, or killer
+         *        moves and then by history if there are heuristics
+         *      + with useSee, the captures that lose material (Board::see(...) < 0) last
+         *
+         * Captures are selected one at a time rather than sorted so the ones that are never
+         * reached are never ordered.  The board must still be in the same position (moves
+         * made on it must have been taken back) each time next(...) is called.
+         *
+         * @param board The board to pick moves for
+         * @param hashMove A move to try before all of the others (ignored if not valid)
+         * @param heuristics The killer moves and history to order quiet moves by (or nullptr)
+         * @param ply The number of plies board is from the root of the search
+         * @param useSee true to hold back the captures that lose material until the end
+         */
+        explicit MovePicker(Board const &board, Move const &hashMove = Move(),
+                            SearchHeuristics const *heuristics = nullptr, size_t ply = 0,
+                            bool useSee = false);
+
+        /**
+         * Walk an already ordered list of moves as is, except for the hash move (if it is in
+         * the list) which comes out first.  With heuristics the quiet moves at the end of the
+         * list (those valued 0, as Board::getMovesSorted(...) leaves them) are put in order
+         * by them first.
+         *
+         * @param moves The moves to hand out, in the order to hand them out
+         * @param hashMove A move to try before all of the others (ignored if not valid)
+         * @param heuristics The killer moves and history to order quiet moves by (or nullptr)
+         * @param side The side the moves are for
+         * @param ply The number of plies the moves are from the root of the search
+         */
+        explicit MovePicker(MoveList const &moves, Move const &hashMove = Move(),
+                            SearchHeuristics const *heuristics = nullptr, Color side = White,
+                            size_t ply = 0);
+
+        /**
+         * Get the next move to search
+         *
+         * @param move Set to the next move if there is one
+         * @return true if there was another move, false once all of the moves are used up
+         */
+        bool next(Move &move);
+
+        /// Get the score used to order a capture: the most valuable victim first and then the
+        /// least valuable attacker
+        static int mvvLva(Board const &board, Move const &move);
+    };
+
+}  // namespace chess
@@ -0,0 +1,119 @@
+//
+// threadpool.h
+//
+// the worker threads every parallel search hands its work to, started once and kept for the
+// life of the program so a search never pays to create threads
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chess {
+    using std::atomic;
+    using std::condition_variable;
+    using std::deque;
+    using std::function;
+    using std::future;
+    using std::mutex;
+    using std::thread;
+    using std::unique_ptr;
+    using std::vector;
+
+    class ThreadPool {
+    public:
+        /// The most worker threads a pool will start
+        static unsigned const MaxThreads = 64u;
+
+    private:
+        /// One worker's own tasks.  It takes the newest from the back while idle workers
+        /// steal the oldest from the front.
+        struct Worker {
+            mutex lock;
+            deque<function<void()>> tasks;
+        };
+
+        // made MaxThreads long up front so workers can look through the queues for work to
+        // steal while more workers are being started
+        unique_ptr<Worker[]> workers;
+        vector<thread> threads;
+        atomic<unsigned> numWorkers{0};
+
+        mutex lock;                    // guards stop, threads and waiting on pending
+        condition_variable available;  // a task was added or the pool is stopping
+        atomic<int> pending{0};        // the queued tasks no worker has taken yet
+        atomic<unsigned> nextWorker{0};  // the queue the next task from outside goes on
+        bool stop{false};
+
+        /// Add a task to the queue of the worker calling this, or to the workers' queues in
+        /// turn when called from outside the pool, and wake a worker to take it.  With no
+        /// workers the task is run right away instead.
+        void push(function<void()> task);
+
+        /// Take the newest task from a worker's own queue, or steal the oldest from another's
+        bool take(unsigned self, function<void()> &task);
+
+        /// A worker's loop: run tasks until the pool is stopped and there are none left
+        void run(unsigned self);
+
+    public:
+        /**
+         * Make a pool with the given number of worker threads (more can be added later)
+         *
+         * @param count The number of workers to start, at most MaxThreads
+         */
+        explicit ThreadPool(unsigned count = 0);
+
+        /// Finish the tasks already added and then stop and join the workers
+        ~ThreadPool();
+
+        ThreadPool(ThreadPool const &) = delete;
+        ThreadPool &operator=(ThreadPool const &) = delete;
+
+        /// Get the pool the searches share, started with no workers the first time it is used
+        static ThreadPool &shared();
+
+        /**
+         * Start more workers until there are at least count of them (at most MaxThreads).
+         * Workers are never stopped before the pool is.
+         *
+         * @param count The number of workers wanted
+         */
+        void reserve(unsigned count);
+
+        /// Get the number of worker threads
+        [[nodiscard]] unsigned size() const { return numWorkers.load(); }
+
+        /// Get a number for the calling thread that no other thread of its pool shares: the
+        /// worker's place in the pool plus one, or 0 for a thread that isn't a pool worker
+        static unsigned threadSlot();
+
+        /**
+         * Queue a task for the workers.  Tasks added by a worker go on its own queue and the
+         * other workers steal them once their own queues are empty.  A task must not wait for
+         * another task that may still be queued behind it: with every worker waiting nothing
+         * would be left to run it.
+         *
+         * @param func The task, called with no arguments on one of the workers
+         * @return A future that is ready (without polling) once the task has returned
+         */
+        template <typename Func> auto submit(Func &&func) -> future<std::invoke_result_t<Func>> {
+            using Result = std::invoke_result_t<Func>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+            future<Result> result = task->get_future();
+            push([task]() { (*task)(); });
+            return result;
+        }
+    };
+
+}  // namespace chess
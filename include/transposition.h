@@ -0,0 +1,157 @@
+/**
+ * The TranspositionTable class keeps the results of searching board positions, keyed by their
+ * Zobrist hash, so positions reached again (by a different move order or a later search) can
+ * reuse them for cutoffs and move ordering
+ *
+ */
+
+#pragma once
+
+#include <chessutil.h>
+#include <move.h>
+#include <threadpool.h>
+#include <zobrist.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace chess {
+    using std::array;
+    using std::atomic;
+    using std::unique_ptr;
+
+    /// The result kept for one searched position
+    struct TTEntry {
+        /// Bound Types
+        /// What the score says about the position's true value
+        static unsigned const None = 0u;   // no entry
+        static unsigned const Exact = 1u;  // the score is the value
+        static unsigned const Lower = 2u;  // the value is at least the score (a beta cutoff)
+        static unsigned const Upper = 3u;  // the value is at most the score (nothing beat alpha)
+
+        PackedMove move;  // the best move found (may be empty)
+        int score{};      // the score in the same white-positive terms minmax uses
+        int depth{};      // the depth the position was searched to
+        unsigned int bound{None};
+        unsigned int age{};  // the search the entry was written in
+
+        [[nodiscard]] bool isValid() const { return bound != None; }
+    };
+
+    class TranspositionTable {
+    public:
+        /// Entries are grouped in buckets of this many, one cache line each
+        static unsigned const BucketSize = 4u;
+
+    private:
+        /**
+         * One entry packed into two 64-bit words.  The key is stored xor'ed with the data so
+         * an entry torn by two threads writing it at once simply fails to match on the next
+         * probe instead of handing back another position's data.  No locks are needed.
+         *
+         *   data bits  0 - 31 : score
+         *   data bits 32 - 47 : packed move
+         *   data bits 48 - 55 : depth (signed)
+         *   data bits 56 - 57 : bound
+         *   data bits 58 - 63 : age
+         */
+        struct Slot {
+            atomic<uint64_t> check{0};
+            atomic<uint64_t> data{0};
+        };
+
+        struct alignas(64) Bucket {
+            Slot slots[BucketSize];
+        };
+
+        /// One thread's counts of the table's use, on a cache line of its own so the threads
+        /// of a search never write over each other to count
+        struct alignas(64) Counts {
+            atomic<long> probes{0};
+            atomic<long> hits{0};
+            atomic<long> stores{0};
+        };
+
+        unique_ptr<Bucket[]> buckets;
+        size_t numBuckets{0};
+        unsigned int age{0};
+        mutable array<Counts, ThreadPool::MaxThreads + 1> counts;  // by ThreadPool::threadSlot()
+
+        static uint64_t pack(TTEntry const &entry);
+        static TTEntry unpack(uint64_t data);
+
+        Bucket &bucketFor(HashKey key) const { return buckets[key & (numBuckets - 1)]; }
+
+        /// Get the calling thread's counts
+        Counts &ownCounts() const { return counts[ThreadPool::threadSlot()]; }
+
+        /// Add up one of the counts over all of the threads
+        long total(atomic<long> Counts::*count) const;
+
+    public:
+
+        /// Make an empty table.  Nothing is allocated until resize(...) is called.
+        TranspositionTable() = default;
+        explicit TranspositionTable(size_t megabytes);
+        TranspositionTable(TranspositionTable const &ref);
+        TranspositionTable &operator=(TranspositionTable const &ref);
+
+        /**
+         * Set the size of the table and clear it.  The number of buckets is the largest power
+         * of two that fits in the given number of megabytes.
+         *
+         * @param megabytes The most memory the table may use
+         */
+        void resize(size_t megabytes);
+
+        /// Remove every entry
+        void clear();
+
+        /// Start a new search so entries from older searches are replaced first
+        void newSearch() { age = (age + 1) & 0x3Fu; }
+
+        /// Get the number of entries the table can hold
+        [[nodiscard]] size_t size() const { return numBuckets * BucketSize; }
+
+        [[nodiscard]] bool empty() const { return numBuckets == 0; }
+
+        /**
+         * Look up a position
+         *
+         * @param key The Zobrist hash of the position
+         * @return The entry for the position or an invalid entry if there isn't one
+         */
+        [[nodiscard]] TTEntry probe(HashKey key) const;
+
+        /**
+         * Keep the result of searching a position.  Within its bucket the position replaces
+         * its own entry, or else the entry that is from the oldest search and the shallowest.
+         * A deeper entry for the same position from this search is kept unless the new one
+         * is exact.
+         *
+         * @param key The Zobrist hash of the position
+         * @param move The best move found or an invalid move if there isn't one
+         * @param score The score of the position
+         * @param depth The depth the position was searched to
+         * @param bound What the score says about the value (TTEntry::Exact etc.)
+         */
+        void store(HashKey key, Move const &move, int score, int depth, unsigned int bound);
+
+        /// Get the number of probes made since the table was last cleared, by all threads
+        [[nodiscard]] long countProbes() const { return total(&Counts::probes); }
+
+        /// Get the number of those probes that found an entry
+        [[nodiscard]] long countHits() const { return total(&Counts::hits); }
+
+        /// Get the number of entries stored since the table was last cleared, by all threads
+        [[nodiscard]] long countStores() const { return total(&Counts::stores); }
+
+        /// Get how full the table is in parts per thousand, sampled from the first buckets
+        [[nodiscard]] int hashFull() const;
+
+        void showMetrics() const;
+    };
+
+}  // namespace chess
@@ -0,0 +1,39 @@
+//
+// zobrist.h
+//
+// the random keys xor'ed together to make a 64-bit hash of a board position
+//
+
+#pragma once
+
+#include <chessutil.h>
+
+#include <cstdint>
+
+namespace chess {
+    /// A 64-bit Zobrist hash of a board position
+    using HashKey = uint64_t;
+
+    /// Castling Rights
+    /// Which castling moves are still possible judging by the kings and rooks that haven't moved
+    static unsigned const WhiteKingSide = 0b0001u;
+    static unsigned const WhiteQueenSide = 0b0010u;
+    static unsigned const BlackKingSide = 0b0100u;
+    static unsigned const BlackQueenSide = 0b1000u;
+
+    /// The column value used when no en passant capture is possible
+    static unsigned const NoEnPassant = 8u;
+
+    /// Get the key for a piece of the given side and type on a spot. Empty spots have no key.
+    HashKey pieceKey(Piece piece, unsigned int ndx);
+
+    /// Get the key for a set of castling rights
+    HashKey castleKey(unsigned int rights);
+
+    /// Get the key for an en passant capture onto the given column (none for NoEnPassant)
+    HashKey enPassantKey(unsigned int col);
+
+    /// Get the key that is xor'ed in when it is White's turn
+    HashKey sideKey();
+
+}  // namespace chess
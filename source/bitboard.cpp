@@ -0,0 +1,252 @@
+//
+// bitboard.cpp
+//
+// precomputed attack tables: magic bitboards for the sliding pieces,
+// simple per-spot tables for knights, kings and pawns and the line tables
+//
+
+#include <bitboard.h>
+
+#include <array>
+#include <vector>
+
+namespace chess {
+    using std::array;
+    using std::vector;
+
+    namespace {
+        /// Magic multipliers for the spots indexed col + row * 8 (a8 is 0 and h1 is 63).
+        /// Each one maps every relevant occupancy of a spot to a unique attack table slot.
+        array<Bitboard const, BOARD_SIZE> const rookMagics = {
+            0x0080002080400010ull, 0x014000600010004cull, 0x1500082001011040ull,
+            0x2080100004080082ull, 0x0100080004110002ull, 0x3100020844008100ull,
+            0xa2800a0003000080ull, 0x0200041020804102ull, 0xd001800080400022ull,
+            0x0003400020065001ull, 0xa080802000100080ull, 0x00c1002010010008ull,
+            0x3000800800800400ull, 0x0080800400020080ull, 0x000400081102c410ull,
+            0x0e03002300004182ull, 0x0140410021008005ull, 0x1200808020004001ull,
+            0x8204860040201200ull, 0x2218008008100080ull, 0x4004010100100800ull,
+            0x0101010002080400ull, 0x1024040002080110ull, 0x80040200048c0c61ull,
+            0x2821004200220080ull, 0x1000200040401000ull, 0x0002200300410010ull,
+            0x88a0100080800800ull, 0x9022100500480100ull, 0x0802000200081004ull,
+            0x0001002100048200ull, 0x100300010029428aull, 0x024040002080009cull,
+            0x0000a00985804000ull, 0x000100d741002000ull, 0x0010000901001020ull,
+            0x2030800801802400ull, 0x6002800400800201ull, 0x0240420104000810ull,
+            0x00890000830004c2ull, 0x0000208040118000ull, 0x0090002000404000ull,
+            0x0004200102110040ull, 0x0080400a12020020ull, 0x442b008040100220ull,
+            0x0212001020040400ull, 0x0340021008040001ull, 0x0081124400860031ull,
+            0x0110204100800900ull, 0x0020068032400080ull, 0x0411001020004100ull,
+            0x9000100208008280ull, 0xc481008020401002ull, 0x0842001008040200ull,
+            0xc000010210488400ull, 0x1401000600a84100ull, 0x10121100208004c5ull,
+            0x1000400020108101ull, 0x9201090020021041ull, 0x0021a01830000501ull,
+            0x0201001008000433ull, 0x08a600280c031006ull, 0x0158020a8d28100cull,
+            0x2080002900440082ull};
+
+        array<Bitboard const, BOARD_SIZE> const bishopMagics = {
+            0x08100401180a0010ull, 0x0820080200902002ull, 0x2050840040401001ull,
+            0x2008208020002000ull, 0x0001104002002000ull, 0x1026080ab8001002ull,
+            0x10010401a0080008ull, 0x8820240208040290ull, 0x0010040408080138ull,
+            0x0008116102208200ull, 0x2002480801342000ull, 0x000c040410840025ull,
+            0x0002011041022004ull, 0x8100021210440040ull, 0x2082004402201000ull,
+            0x0280482401382804ull, 0x4028800521040408ull, 0x0002003010220292ull,
+            0x0104003204001200ull, 0x002c201a02020404ull, 0x0154030211200000ull,
+            0x600820a410041004ull, 0xa040a00602012080ull, 0x0020208101180200ull,
+            0x8010320205041001ull, 0x84262002100416c0ull, 0x8601100001040420ull,
+            0x0204010000200880ull, 0x0010840000802004ull, 0x800042001d008200ull,
+            0x841094048109280aull, 0x4246020408809080ull, 0x0048a84001080200ull,
+            0x4002020300301040ull, 0x0804002402022400ull, 0x5032020080080080ull,
+            0x0040208020820020ull, 0x0490404040860105ull, 0x0204040060048822ull,
+            0x8034004140018420ull, 0x401804450428a098ull, 0x0c84039844c00800ull,
+            0x400b0041a6021000ull, 0x3080922024204801ull, 0x0200200410400408ull,
+            0x084811180a010022ull, 0x00049000810c4201ull, 0x0002024200200200ull,
+            0x8280882802105005ull, 0xa001464804104801ull, 0x0000008048080018ull,
+            0x2808010420a81300ull, 0x0025148410440100ull, 0x0800401002269520ull,
+            0x0022221007010808ull, 0x0002101400829200ull, 0x0005802098044008ull,
+            0x0800011400920814ull, 0x0002404024024802ull, 0x103080c030420204ull,
+            0x1100600040229200ull, 0x8002604010028080ull, 0x522821a004009490ull,
+            0x0003180800808202ull};
+
+        using Directions = array<array<int, 2>, 4>;
+
+        // opposite directions are kept next to each other
+        Directions const rookDirections = {{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}};
+        Directions const bishopDirections = {{{-1, -1}, {1, 1}, {1, -1}, {-1, 1}}};
+
+        /// The relevant occupancy mask, magic multiplier and attack table offset for one spot
+        struct Magic {
+            Bitboard mask{};
+            Bitboard magic{};
+            unsigned int shift{};
+            size_t offset{};
+
+            [[nodiscard]] size_t index(Bitboard const occupied) const {
+                return offset + static_cast<size_t>(((occupied & mask) * magic) >> shift);
+            }
+        };
+
+        /// Walk one direction from a spot one step at a time stopping at the first occupied
+        /// spot. When 'edges' is false the last spot before the edge of the board is left
+        /// out, which gives the spots whose occupancy matters for the attack set.
+        Bitboard slideRay(unsigned int const ndx, Bitboard const occupied,
+                          array<int, 2> const &dir, bool const edges) {
+            Bitboard attacks = NoSpots;
+            int col = int(ndx % 8) + dir[0];
+            int row = int(ndx / 8) + dir[1];
+            while (col >= 0 && col <= 7 && row >= 0 && row <= 7) {
+                int const nextCol = col + dir[0];
+                int const nextRow = row + dir[1];
+                bool const atEdge = nextCol < 0 || nextCol > 7 || nextRow < 0 || nextRow > 7;
+                if (atEdge && !edges) break;
+
+                Bitboard const bit = spotBit(col + row * 8);
+                attacks |= bit;
+                if (occupied & bit) break;
+                col = nextCol;
+                row = nextRow;
+            }
+            return attacks;
+        }
+
+        Bitboard slideAttacks(unsigned int const ndx, Bitboard const occupied,
+                              Directions const &directions, bool const edges) {
+            Bitboard attacks = NoSpots;
+            for (auto const &dir : directions) {
+                attacks |= slideRay(ndx, occupied, dir, edges);
+            }
+            return attacks;
+        }
+
+        /// The rook and bishop attack tables, filled in once on first use
+        struct SliderTables {
+            array<Magic, BOARD_SIZE> rook{};
+            array<Magic, BOARD_SIZE> bishop{};
+            vector<Bitboard> attacks;
+
+            SliderTables() {
+                fill(rook, rookMagics, rookDirections);
+                fill(bishop, bishopMagics, bishopDirections);
+            }
+
+            void fill(array<Magic, BOARD_SIZE> &magics,
+                      array<Bitboard const, BOARD_SIZE> const &multipliers,
+                      Directions const &directions) {
+                for (unsigned int ndx = 0; ndx < BOARD_SIZE; ndx++) {
+                    Magic &m = magics[ndx];
+                    m.mask = slideAttacks(ndx, NoSpots, directions, false);
+                    m.magic = multipliers[ndx];
+                    m.shift = 64u - static_cast<unsigned int>(popCount(m.mask));
+                    m.offset = attacks.size();
+                    attacks.resize(attacks.size() + (size_t(1) << popCount(m.mask)));
+
+                    // visit every subset of the mask (the Carry-Rippler trick)
+                    Bitboard occupied = NoSpots;
+                    do {
+                        attacks[m.index(occupied)] = slideAttacks(ndx, occupied, directions, true);
+                        occupied = (occupied - m.mask) & m.mask;
+                    } while (occupied);
+                }
+            }
+        };
+
+        SliderTables const &sliderTables() {
+            static SliderTables const tables;
+            return tables;
+        }
+
+        /// The knight, king and pawn attack tables, filled in once on first use
+        struct StepTables {
+            array<Bitboard, BOARD_SIZE> knight{};
+            array<Bitboard, BOARD_SIZE> king{};
+            array<array<Bitboard, BOARD_SIZE>, 2> pawn{};
+
+            StepTables() {
+                static array<array<int, 2>, 8> const knightSteps
+                    = {{{-1, -2}, {1, -2}, {-1, 2}, {1, 2}, {-2, -1}, {2, -1}, {-2, 1}, {2, 1}}};
+                static array<array<int, 2>, 8> const kingSteps
+                    = {{{-1, -1}, {1, -1}, {-1, 1}, {1, 1}, {0, -1}, {0, 1}, {-1, 0}, {1, 0}}};
+
+                for (unsigned int ndx = 0; ndx < BOARD_SIZE; ndx++) {
+                    for (auto const &step : knightSteps) knight[ndx] |= stepTo(ndx, step);
+                    for (auto const &step : kingSteps) king[ndx] |= stepTo(ndx, step);
+
+                    // white pawns move towards row 0 and black pawns towards row 7
+                    pawn[White][ndx] = stepTo(ndx, {-1, -1}) | stepTo(ndx, {1, -1});
+                    pawn[Black][ndx] = stepTo(ndx, {-1, 1}) | stepTo(ndx, {1, 1});
+                }
+            }
+
+            /// Get the spot one step away from a spot or no spot if the step leaves the board
+            static Bitboard stepTo(unsigned int const ndx, array<int, 2> const &step) {
+                int const col = int(ndx % 8) + step[0];
+                int const row = int(ndx / 8) + step[1];
+                if (col < 0 || col > 7 || row < 0 || row > 7) return NoSpots;
+                return spotBit(col + row * 8);
+            }
+        };
+
+        StepTables const &stepTables() {
+            static StepTables const tables;
+            return tables;
+        }
+
+        /// The spots between and the whole line through every pair of spots that share a
+        /// row, column or diagonal, filled in once on first use
+        struct LineTables {
+            array<array<Bitboard, BOARD_SIZE>, BOARD_SIZE> between{};
+            array<array<Bitboard, BOARD_SIZE>, BOARD_SIZE> line{};
+
+            LineTables() {
+                for (unsigned int from = 0; from < BOARD_SIZE; from++) {
+                    for (Directions const *directions : {&rookDirections, &bishopDirections}) {
+                        for (unsigned int d = 0; d < directions->size(); d++) {
+                            // the directions come in opposite pairs: 0 and 1, 2 and 3
+                            auto const &dir = (*directions)[d];
+                            auto const &opposite = (*directions)[d ^ 1u];
+                            Bitboard const full = spotBit(from) | slideRay(from, NoSpots, dir, true)
+                                                  | slideRay(from, NoSpots, opposite, true);
+
+                            Bitboard spots = slideRay(from, NoSpots, dir, true);
+                            while (spots) {
+                                unsigned int const to = popLsb(spots);
+                                between[from][to]
+                                    = slideRay(from, spotBit(to), dir, true) & ~spotBit(to);
+                                line[from][to] = full;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        LineTables const &lineTables() {
+            static LineTables const tables;
+            return tables;
+        }
+    }  // namespace
+
+    Bitboard rookAttacks(unsigned int const ndx, Bitboard const occupied) {
+        SliderTables const &tables = sliderTables();
+        return tables.attacks[tables.rook[ndx].index(occupied)];
+    }
+
+    Bitboard bishopAttacks(unsigned int const ndx, Bitboard const occupied) {
+        SliderTables const &tables = sliderTables();
+        return tables.attacks[tables.bishop[ndx].index(occupied)];
+    }
+
+    Bitboard knightAttacks(unsigned int const ndx) { return stepTables().knight[ndx]; }
+
+    Bitboard kingAttacks(unsigned int const ndx) { return stepTables().king[ndx]; }
+
+    Bitboard pawnAttacks(Color const side, unsigned int const ndx) {
+        return stepTables().pawn[side][ndx];
+    }
+
+    Bitboard betweenSpots(unsigned int const from, unsigned int const to) {
+        return lineTables().between[from][to];
+    }
+
+    Bitboard lineThrough(unsigned int const from, unsigned int const to) {
+        return lineTables().line[from][to];
+    }
+
+}  // namespace chess
@@ -8,7 +8,10 @@
 #include <algorithm>
 #include <iterator>
 
+using std::count;
 using std::find;
+using std::max;
+using std::remove_if;
 using std::toupper;
 
 namespace chess {
@@ -51,6 +54,83 @@ namespace chess {
         generateMoveLists();
     }
 
+    /// the spots whose kings and rooks decide the castling rights
+    static Bitboard const castleSpots = spotBit(0) | spotBit(4) | spotBit(7) | spotBit(56)
+                                        | spotBit(60) | spotBit(63);
+
+    void Board::setSpot(unsigned int const ndx, Piece const piece) {
+        Bitboard const bit = spotBit(ndx);
+        bool const castleSpot = (castleSpots & bit) != NoSpots;
+        unsigned int const rights = castleSpot ? getCastleRights() : 0;
+
+        Piece const old = board[ndx];
+        if (!chess::isEmpty(old)) {
+            pieceBits[chess::getType(old)] &= ~bit;
+            sideBits[chess::getSide(old)] &= ~bit;
+            hash ^= pieceKey(old, ndx);
+        }
+        board[ndx] = piece;
+        if (!chess::isEmpty(piece)) {
+            pieceBits[chess::getType(piece)] |= bit;
+            sideBits[chess::getSide(piece)] |= bit;
+            hash ^= pieceKey(piece, ndx);
+        }
+
+        if (castleSpot) {
+            hash ^= castleKey(rights) ^ castleKey(getCastleRights());
+        }
+    }
+
+    void Board::updateBitboards() {
+        pieceBits.fill(NoSpots);
+        sideBits.fill(NoSpots);
+        for (unsigned int ndx = 0; ndx < BOARD_SIZE; ndx++) {
+            Piece const piece = board[ndx];
+            if (chess::isEmpty(piece)) continue;
+            pieceBits[chess::getType(piece)] |= spotBit(ndx);
+            sideBits[chess::getSide(piece)] |= spotBit(ndx);
+        }
+        hash = computeHash();
+    }
+
+    HashKey Board::computeHash() const {
+        HashKey key = castleKey(getCastleRights()) ^ enPassantKey(getEnPassantCol());
+        for (unsigned int ndx = 0; ndx < BOARD_SIZE; ndx++) {
+            key ^= pieceKey(board[ndx], ndx);
+        }
+        return key;
+    }
+
+    unsigned int Board::getCastleRights() const {
+        auto const unmoved = [this](unsigned int const ndx, Piece const type, Color const side) {
+            return (board[ndx] & (Type | Side | Moved)) == makeSpot(type, side);
+        };
+
+        unsigned int rights = 0;
+        if (unmoved(4 + 7 * 8, King, White)) {
+            if (unmoved(7 + 7 * 8, Rook, White)) rights |= WhiteKingSide;
+            if (unmoved(0 + 7 * 8, Rook, White)) rights |= WhiteQueenSide;
+        }
+        if (unmoved(4 + 0 * 8, King, Black)) {
+            if (unmoved(7 + 0 * 8, Rook, Black)) rights |= BlackKingSide;
+            if (unmoved(0 + 0 * 8, Rook, Black)) rights |= BlackQueenSide;
+        }
+        return rights;
+    }
+
+    unsigned int Board::getEnPassantCol() const {
+        if (history.empty()) return NoEnPassant;
+        Move const &last = history.back();
+        if (getType(last.getTo()) != Pawn) return NoEnPassant;
+        if (abs(int(last.getFromRow()) - int(last.getToRow())) != 2) return NoEnPassant;
+        return last.getToCol();
+    }
+
+    int Board::countRepetitions() const {
+        HashKey const key = getHash();
+        return static_cast<int>(count(hashHistory.begin(), hashHistory.end(), key));
+    }
+
     bool Board::isEmpty(unsigned int const ndx) const { return chess::isEmpty(board[ndx]); }
 
     Piece Board::getType(unsigned int const ndx) const { return chess::getType(board[ndx]); }
@@ -66,15 +146,20 @@ namespace chess {
     bool Board::isPromoted(unsigned int const ndx) const { return chess::isPromoted(board[ndx]); }
 
     void Board::setType(unsigned int const ndx, Piece type) {
-        board[ndx] = chess::setType(board[ndx], type);
+        setSpot(ndx, chess::setType(board[ndx], type));
     }
 
     void Board::setSide(unsigned int const ndx, Piece side) {
-        board[ndx] = chess::setSide(board[ndx], side);
+        setSpot(ndx, chess::setSide(board[ndx], side));
     }
 
     void Board::setMoved(unsigned int const ndx, bool hasMoved) {
+        bool const castleSpot = (castleSpots & spotBit(ndx)) != NoSpots;
+        unsigned int const rights = castleSpot ? getCastleRights() : 0;
         board[ndx] = chess::setMoved(board[ndx], hasMoved);
+        if (castleSpot) {
+            hash ^= castleKey(rights) ^ castleKey(getCastleRights());
+        }
     }
 
     void Board::setCheck(unsigned int const ndx, bool inCheck) {
@@ -128,8 +213,12 @@ namespace chess {
     }
 
     void Board::generateMoveLists() {
+        // the board array may have been set up directly so bring the bitboards in sync first
+        updateBitboards();
+
         moves1 = getMovesSorted(turn);
         moves2 = getMovesSorted((turn + 1) % 2);
+        moves1Ready = moves2Ready = true;
 
         // at this point the Side (Black or White) constant is in the .turn value
         // for the board.  Whichever color is to move next, it's moves are in
@@ -164,25 +253,38 @@ namespace chess {
         return true;
     }
 
+    /**
+     * See if a spot is attacked by any piece of the specified side.  Rather than
+     * generating all of that side's moves this looks outward from the spot using
+     * the knight, king, pawn and sliding piece attack patterns.
+     *
+     * @param ndx The index of the spot to check
+     * @param bySide The side whose pieces may be attacking the spot
+     * @return true if any piece of bySide attacks the spot
+     */
+    bool Board::isSquareAttacked(unsigned int const ndx, Color const bySide) const {
+        Bitboard const attackers = sideBits[bySide];
+
+        // a pawn of bySide attacks this spot if it sits where one of ours would attack from here
+        if (pawnAttacks((bySide + 1) % 2, ndx) & pieceBits[Pawn] & attackers) return true;
+        if (knightAttacks(ndx) & pieceBits[Knight] & attackers) return true;
+        if (kingAttacks(ndx) & pieceBits[King] & attackers) return true;
+
+        Bitboard const occupied = getOccupied();
+        Bitboard const queens = pieceBits[Queen];
+        if (bishopAttacks(ndx, occupied) & (pieceBits[Bishop] | queens) & attackers) return true;
+        return (rookAttacks(ndx, occupied) & (pieceBits[Rook] | queens) & attackers) != NoSpots;
+    }
+
     /**
      * See if the king is in check for the specified side
      *
      * @param side The side to check for
      * @return true if the king is in check
-     * spot
      */
     bool Board::kingIsInCheck(Color const side) const {
-        unsigned int ndx = (side == White) ? ndxKing1 : ndxKing2;
-
-        /// generate our opponents current moves
-        auto const &opponentMoves = getMoves((side + 1) % 2, false);
-        /// see if any of our opponents moves can reach the king's spot
-        for (auto const &move : opponentMoves) {
-            if (move.getTo() == ndx) {
-                return true;
-            }
-        }
-        return false;
+        unsigned int const ndx = (side == White) ? ndxKing1 : ndxKing2;
+        return isSquareAttacked(ndx, (side + 1) % 2);
     }
 
     /**
@@ -190,9 +292,9 @@ namespace chess {
      * If the move captures a piece then the Move object is updated with the captured piece.
      *
      * @param move The Move to make
-     * @return nothing
+     * @return the state needed by undoMove(...) to take the move back
      */
-    void Board::executeMove(Move &move) {
+    MoveUndo Board::executeMove(Move &move) {
         unsigned int const fx = move.getFromCol();
         unsigned int const fy = move.getFromRow();
         unsigned int const tx = move.getToCol();
@@ -206,12 +308,24 @@ namespace chess {
         Piece const fromType = chess::getType(piece);
         Piece const toType = chess::getType(toPiece);
 
+        unsigned int const enPassantCol = getEnPassantCol();
+        hashHistory.push_back(getHash());
+
+        MoveUndo undo;
+        undo.moved = piece;
+        undo.captured = toPiece;
+        undo.capturedNdx = ti;
+        undo.turn = turn;
+        undo.turns = turns;
+
         // update the taken pieces list (if necessary)
         PieceList &takenList = (turn == White) ? taken1 : taken2;
         if (fromType == Pawn && toType == Empty && fx != tx) {  // en-passant capture
             takenList.push_back(Pawn);
-            move.setCaptured(board[tx + fy * 8]);
-            board[tx + fy * 8] = Empty;
+            undo.captured = board[tx + fy * 8];
+            undo.capturedNdx = tx + fy * 8;
+            move.setCaptured(undo.captured);
+            setSpot(tx + fy * 8, Empty);
         } else {
             if (toType != Empty) {
                 // This move captures a piece
@@ -223,8 +337,8 @@ namespace chess {
         Color fromSide = chess::getSide(piece);
 
         /// make the move on the board
-        board[ti] = piece;
-        board[fi] = Empty;
+        setSpot(ti, piece);
+        setSpot(fi, Empty);
         setMoved(ti, true);
 
         // See if this is a Castling move:
@@ -238,9 +352,11 @@ namespace chess {
                 unsigned int const rti
                     = (delta < 0) ? fy * 8 + 3 : fy * 8 + 5;  // index to move rook to
                 // move the rook
-                board[rti] = board[rfi];
+                undo.rook = board[rfi];
+                undo.rookNdx = rfi;
+                setSpot(rti, board[rfi]);
                 setMoved(rti, true);
-                board[rfi] = Empty;
+                setSpot(rfi, Empty);
             }
 
             // keep the kings positions up to date
@@ -251,14 +367,88 @@ namespace chess {
             }
 
         } else if (fromType == Pawn) {
-            // see if this pawn has reached the other side and promote it to a queen if so
+            // see if this pawn has reached the other side and promote it (to a queen unless
+            // the move says otherwise) if so
             if ((ty == 0 && fromSide == White) || (ty == 7 && fromSide == Black)) {
-                setType(ti, Queen);
+                setType(ti, move.isPromotion() ? move.getPromotion() : Queen);
                 setPromoted(ti);
             }
         }
 
         history.push_back(move);
+        hash ^= enPassantKey(enPassantCol) ^ enPassantKey(getEnPassantCol());
+        moves1Ready = moves2Ready = false;
+
+        return undo;
+    }
+
+    /**
+     * Take back a move made with executeMove(...) putting the moved piece, any captured
+     * piece and any castled rook back where they were along with their moved and promoted
+     * flags.  The king positions, taken pieces lists, history, turn and turns are restored
+     * too.  The move lists are not; getMoves1() and getMoves2() regenerate them when needed.
+     *
+     * @param move The Move that was made
+     * @param undo The value returned by executeMove(...) when the move was made
+     * @return nothing
+     */
+    void Board::undoMove(Move const &move, MoveUndo const &undo) {
+        unsigned int const fi = move.getFrom();
+        unsigned int const ti = move.getTo();
+        unsigned int const enPassantCol = getEnPassantCol();
+
+        if (undo.rook != Empty) {
+            // put the castled rook back in the corner
+            unsigned int const rti = (undo.rookNdx < ti) ? undo.rookNdx + 3 : undo.rookNdx - 2;
+            setSpot(rti, Empty);
+            setSpot(undo.rookNdx, undo.rook);
+        }
+
+        setSpot(ti, Empty);
+        setSpot(fi, undo.moved);
+        if (undo.captured != Empty) {
+            setSpot(undo.capturedNdx, undo.captured);
+            PieceList &takenList = (undo.turn == White) ? taken1 : taken2;
+            takenList.pop_back();
+        }
+
+        if (chess::getType(undo.moved) == King) {
+            if (chess::getSide(undo.moved) == White) {
+                ndxKing1 = fi;
+            } else {
+                ndxKing2 = fi;
+            }
+        }
+
+        history.pop_back();
+        if (!hashHistory.empty()) hashHistory.pop_back();
+        hash ^= enPassantKey(enPassantCol) ^ enPassantKey(getEnPassantCol());
+        turn = undo.turn;
+        turns = undo.turns;
+        moves1Ready = moves2Ready = false;
+    }
+
+    MoveUndo Board::executeNullMove() {
+        unsigned int const enPassantCol = getEnPassantCol();
+        hashHistory.push_back(getHash());
+
+        MoveUndo undo;
+        undo.turn = turn;
+        undo.turns = turns;
+
+        history.push_back(Move());
+        hash ^= enPassantKey(enPassantCol) ^ enPassantKey(NoEnPassant);
+        moves1Ready = moves2Ready = false;
+        return undo;
+    }
+
+    void Board::undoNullMove(MoveUndo const &undo) {
+        history.pop_back();
+        if (!hashHistory.empty()) hashHistory.pop_back();
+        hash ^= enPassantKey(NoEnPassant) ^ enPassantKey(getEnPassantCol());
+        turn = undo.turn;
+        turns = undo.turns;
+        moves1Ready = moves2Ready = false;
     }
 
     /**
@@ -280,7 +470,34 @@ namespace chess {
     void Board::advanceTurn() {
         turns++;
         turn = ((turn + 1) % 2);
-        generateMoveLists();
+
+        // the bitboards were kept up to date by executeMove(...) so there is no
+        // need to rebuild them the way generateMoveLists() does
+        moves1 = getMovesSorted(turn);
+        moves2 = getMovesSorted((turn + 1) % 2);
+        moves1Ready = moves2Ready = true;
+    }
+
+    void Board::nextTurn() {
+        turns++;
+        turn = ((turn + 1) % 2);
+        moves1Ready = moves2Ready = false;
+    }
+
+    MoveList const &Board::getMoves1() const {
+        if (!moves1Ready) {
+            moves1 = getMovesSorted(turn);
+            moves1Ready = true;
+        }
+        return moves1;
+    }
+
+    MoveList const &Board::getMoves2() const {
+        if (!moves2Ready) {
+            moves2 = getMovesSorted((turn + 1) % 2);
+            moves2Ready = true;
+        }
+        return moves2;
     }
 
     MoveList Board::getMovesSorted(Piece const side) const {
@@ -295,41 +512,283 @@ namespace chess {
      * Get a list of all legal moves currently available for the specified side
      *
      * @param side The side to get moves for
-     * @param checkKing Flag indicating whether to check each move to see if it places
-     *                  the king in check.
-     *                  *NOTE* Setting this flag to true causes the method to call itself
-     *                  recursively after making the move for each valid move available to
-     *                  the opponent to see if the initial move placed the king in check.
+     * @param checkKing Flag indicating whether to leave out moves that place the king
+     *                  in check.  When the side's king is where ndxKing1 or ndxKing2 says
+     *                  it is this uses getLegalMoves(...), otherwise every move is made and
+     *                  checked by cleanupMoves(...)
+     * @param targets Only moves to these spots are wanted.  An en passant capture counts as a
+     *                move to the spot of the pawn it captures
      * @return A list of all valid moves currently available for the specified side
      *
      */
-    MoveList Board::getMoves(Piece const side, bool checkKing) const {
+    MoveList Board::getMoves(Piece const side, bool checkKing, Bitboard const targets) const {
+        unsigned int const ndxKing = (side == White) ? ndxKing1 : ndxKing2;
+        if (checkKing && getType(ndxKing) == King && getSide(ndxKing) == side) {
+            return getLegalMoves(side, targets);
+        }
+
         MoveList moves;
-        moves.reserve(512);
 
-        for (unsigned int ndx = 0; ndx < BOARD_SIZE; ndx++) {
-            if ((getType(ndx) == Empty) || getSide(ndx) != side) continue;
-
-            unsigned int const col = ndx % 8;
-            unsigned int const row = ndx / 8;
-
-            switch (getType(ndx)) {
-                case Pawn:      getPawnMoves(moves, col, row);      break;
-                case Rook:      getRookMoves(moves, col, row);      break;
-                case Knight:    getKnightMoves(moves, col, row);    break;
-                case Bishop:    getBishopMoves(moves, col, row);    break;
-                case Queen:     getQueenMoves(moves, col, row);     break;
-                case King:      getKingMoves(moves, col, row);      break;
-            }
+        // visit only the spots occupied by this side, lowest index first
+        Bitboard pieces = sideBits[side];
+        while (pieces) {
+            addPieceMoves(moves, popLsb(pieces), AllSpots);
         }
 
         if (checkKing) {
             moves = cleanupMoves(moves, side);
         }
 
+        if (targets != AllSpots) {
+            auto const last = remove_if(moves.begin(), moves.end(), [&](Move const &move) {
+                return (targets & spotBit(getTargetSpot(move))) == NoSpots;
+            });
+            moves.erase(last, moves.end());
+        }
+
         return moves;
     }
 
+    /**
+     * Get a list of only the legal moves for the specified side.  The pieces checking
+     * the king and the pieces pinned to it are worked out once up front:
+     *
+     *      + in double check only the king can move
+     *      + in single check the other pieces can only capture or block the checker
+     *      + a pinned piece can only move along the line through it and the king
+     *      + the king can only move to spots the opponent doesn't attack
+     *
+     * Castling and en passant captures move or remove a second piece so those are
+     * checked by making the move on a copy of the board.  The side's king must be on
+     * the spot in ndxKing1 or ndxKing2.
+     *
+     * @param side The side to get moves for
+     * @param targets Only moves to these spots are wanted.  An en passant capture counts as a
+     *                move to the spot of the pawn it captures
+     * @param firstOnly true to stop after the first piece that has a legal move
+     * @return The same moves getMoves(side, true, targets) gives, in the same order, or with
+     *         firstOnly just the first piece's
+     */
+    MoveList Board::getLegalMoves(Color const side, Bitboard const targets,
+                                  bool const firstOnly) const {
+        MoveList moves;
+
+        Color const opponent = (side + 1) % 2;
+        unsigned int const ndxKing = (side == White) ? ndxKing1 : ndxKing2;
+        Bitboard const occupied = getOccupied();
+        Bitboard const checkers = attackersTo(ndxKing, occupied) & sideBits[opponent];
+        Bitboard const pinned = getPinned(side, ndxKing);
+
+        // the spots a piece other than the king can move to without leaving the king in check
+        Bitboard evasions = AllSpots;
+        if (checkers) {
+            evasions = (popCount(checkers) > 1)
+                           ? NoSpots
+                           : checkers | betweenSpots(ndxKing, lsb(checkers));
+        }
+
+        Bitboard pieces = sideBits[side];
+        while (pieces && !(firstOnly && !moves.empty())) {
+            unsigned int const ndx = popLsb(pieces);
+            Piece const type = getType(ndx);
+            if (type != King && evasions == NoSpots) continue;
+
+            Bitboard allowed = evasions & targets;
+            if (pinned & spotBit(ndx)) {
+                allowed &= lineThrough(ndxKing, ndx);
+            }
+
+            size_t const first = moves.size();
+            addPieceMoves(moves, ndx, allowed);
+            if (type != Pawn && type != King) continue;
+
+            // pawn and king moves aren't generated from bitboards so check each one
+            auto const last
+                = remove_if(moves.begin() + first, moves.end(), [&](Move const &move) {
+                      unsigned int const ti = move.getTo();
+                      if (type == King) {
+                          if ((targets & spotBit(ti)) == NoSpots) return true;
+                          if (abs(int(move.getToCol()) - int(move.getFromCol())) == 2) {
+                              return !leavesKingSafe(move, side);
+                          }
+                          Bitboard const without = occupied & ~spotBit(ndx);
+                          return (attackersTo(ti, without) & sideBits[opponent]) != NoSpots;
+                      }
+                      if (move.getFromCol() != move.getToCol() && isEmpty(ti)) {
+                          if ((targets & spotBit(getTargetSpot(move))) == NoSpots) return true;
+                          return !leavesKingSafe(move, side);
+                      }
+                      return (allowed & spotBit(ti)) == NoSpots;
+                  });
+            moves.erase(last, moves.end());
+        }
+
+        return moves;
+    }
+
+    /**
+     * See if a side has any legal move, stopping at the first piece that has one rather
+     * than building and sorting the full list
+     *
+     * @param side The side to check
+     * @return true if the side has at least one legal move
+     */
+    bool Board::hasLegalMove(Color const side) const {
+        if (side == turn && moves1Ready) return !moves1.empty();
+        if (side != turn && moves2Ready) return !moves2.empty();
+
+        unsigned int const ndxKing = (side == White) ? ndxKing1 : ndxKing2;
+        if (getType(ndxKing) == King && getSide(ndxKing) == side) {
+            return !getLegalMoves(side, AllSpots, true).empty();
+        }
+        return !getMoves(side, true).empty();
+    }
+
+    /**
+     * Get the spot a move captures on, or for a non-capturing move the spot it moves to.
+     * These only differ for en passant captures.
+     *
+     * @param move The move to check
+     * @return The index of the spot
+     */
+    unsigned int Board::getTargetSpot(Move const &move) const {
+        unsigned int const ti = move.getTo();
+        if (getType(move.getFrom()) == Pawn && move.getFromCol() != move.getToCol()
+            && isEmpty(ti)) {
+            return move.getToCol() + move.getFromRow() * 8;
+        }
+        return ti;
+    }
+
+    /**
+     * Make a move on a copy of the board and see if it leaves the king in check.
+     *
+     * @param move The move to check
+     * @param side The side making the move
+     * @return true if the move does not leave the side's king in check
+     */
+    bool Board::leavesKingSafe(Move const &move, Color const side) const {
+        Board current(*this);
+        Move made(move);
+        current.executeMove(made);
+        return !current.kingIsInCheck(side);
+    }
+
+    /**
+     * Get the pieces of the specified side that are pinned to a spot (the king's spot)
+     * by an opponent rook, bishop or queen.
+     *
+     * @param side The side to find pinned pieces for
+     * @param ndx The spot the pieces are pinned to
+     * @return The spots of the pinned pieces
+     */
+    Bitboard Board::getPinned(Color const side, unsigned int const ndx) const {
+        Color const opponent = (side + 1) % 2;
+        Bitboard const occupied = getOccupied();
+        Bitboard const queens = pieceBits[Queen];
+        Bitboard snipers = ((rookAttacks(ndx, NoSpots) & (pieceBits[Rook] | queens))
+                            | (bishopAttacks(ndx, NoSpots) & (pieceBits[Bishop] | queens)))
+                           & sideBits[opponent];
+
+        Bitboard pinned = NoSpots;
+        while (snipers) {
+            Bitboard const blockers = betweenSpots(ndx, popLsb(snipers)) & occupied;
+            if (popCount(blockers) == 1) {
+                pinned |= blockers & sideBits[side];
+            }
+        }
+        return pinned;
+    }
+
+    /**
+     * Get all of the pieces (of both sides) that attack a spot
+     *
+     * @param ndx The spot to check
+     * @param occupied The occupied spots to use for the sliding pieces
+     * @return The spots of the pieces attacking the spot
+     */
+    Bitboard Board::attackersTo(unsigned int const ndx, Bitboard const occupied) const {
+        Bitboard const queens = pieceBits[Queen];
+        return (pawnAttacks(Black, ndx) & getPieces(White, Pawn))
+               | (pawnAttacks(White, ndx) & getPieces(Black, Pawn))
+               | (knightAttacks(ndx) & pieceBits[Knight]) | (kingAttacks(ndx) & pieceBits[King])
+               | (bishopAttacks(ndx, occupied) & (pieceBits[Bishop] | queens))
+               | (rookAttacks(ndx, occupied) & (pieceBits[Rook] | queens));
+    }
+
+    int Board::see(Move const &move) const {
+        // kings are worth more than anything else that can be won but not so much that the
+        // sums below could overflow
+        auto const value = [](Piece const type) {
+            return (type == King) ? 10 * pieceValues[Queen] : pieceValues[type];
+        };
+
+        unsigned int const from = move.getFrom();
+        unsigned int const to = move.getTo();
+        unsigned int const target = getTargetSpot(move);
+
+        array<int, 32> gain{};
+        gain[0] = isEmpty(target) ? 0 : value(getType(target));
+        Piece onSpot = getType(from);
+        if (onSpot == Pawn && (to / 8 == 0 || to / 8 == 7)) {
+            onSpot = move.isPromotion() ? move.getPromotion() : Queen;
+            gain[0] += value(onSpot) - value(Pawn);
+        }
+
+        Bitboard occupied = getOccupied() & ~spotBit(from) & ~spotBit(target);
+        Color side = (getSide(from) + 1) % 2;
+        size_t depth = 0;
+
+        while (depth + 1 < gain.size()) {
+            // the exchange so far if the side to capture takes the piece now on the spot
+            depth++;
+            gain[depth] = value(onSpot) - gain[depth - 1];
+
+            // pieces already used are out of occupied which lets the ones behind them through
+            Bitboard const attackers = attackersTo(to, occupied) & occupied;
+            Bitboard const ours = attackers & sideBits[side];
+            if (ours == NoSpots) break;
+
+            Piece type = Pawn;
+            while ((ours & pieceBits[type]) == NoSpots) type++;
+            if (type == King && (attackers & sideBits[(side + 1) % 2]) != NoSpots) break;
+
+            occupied &= ~spotBit(lsb(ours & pieceBits[type]));
+            onSpot = type;
+            side = (side + 1) % 2;
+        }
+
+        // either side can stop capturing when going on would cost more than it wins
+        while (--depth > 0) {
+            gain[depth - 1] = -max(-gain[depth - 1], gain[depth]);
+        }
+        return gain[0];
+    }
+
+    /**
+     * Add the moves for the piece on a spot to a list
+     *
+     * @param moves The list to add to
+     * @param ndx The spot of the piece to get moves for
+     * @param allowed The spots knights, bishops, rooks and queens are allowed to move to.
+     *                Pawn and king moves are not limited by it.
+     * @return nothing
+     */
+    void Board::addPieceMoves(MoveList &moves, unsigned int const ndx,
+                              Bitboard const allowed) const {
+        unsigned int const col = ndx % 8;
+        unsigned int const row = ndx / 8;
+
+        switch (getType(ndx)) {
+            case Pawn:      getPawnMoves(moves, col, row);                break;
+            case Rook:      getRookMoves(moves, col, row, allowed);       break;
+            case Knight:    getKnightMoves(moves, col, row, allowed);     break;
+            case Bishop:    getBishopMoves(moves, col, row, allowed);     break;
+            case Queen:     getQueenMoves(moves, col, row, allowed);      break;
+            case King:      getKingMoves(moves, col, row);                break;
+        }
+    }
+
     /**
      * Clean a list of moves by removing any moves that place the king in check
      *
@@ -340,12 +799,13 @@ namespace chess {
      */
     MoveList Board::cleanupMoves(MoveList &moves, Piece const side) const {
         MoveList valid;
+        Board current(*this);
         for (Move &move : moves) {
-            Board current(*this);
-            current.executeMove(move);
+            MoveUndo const undo = current.executeMove(move);
             if (!current.kingIsInCheck(side)) {
                 valid.push_back(move);
             }
+            current.undoMove(move, undo);
         }
 
         return valid;
@@ -385,6 +845,7 @@ namespace chess {
         unsigned int const ti = toCol + toRow * 8;      // to index 0 - 63
 
         int value = 0;
+        unsigned int flag = PackedMove::Normal;
         Piece pieceType = getType(fi);
         Piece pieceSide = getSide(fi);
 
@@ -420,48 +881,40 @@ namespace chess {
                     }
                     // capturing en passant
                     value = getValue(Pawn);
+                    flag = PackedMove::EnPassant;
                 } else {
                     // capturing normal
                     value = getValue(ti);
                 }
             }
+            if (toRow == 0 || toRow == 7) {
+                flag = PackedMove::Promotion;
+            }
+        } else if (pieceType == King && abs(int(fromCol) - int(toCol)) == 2) {
+            flag = PackedMove::Castle;
         }
 
-        moves.emplace_back(fromCol, fromRow, toCol, toRow, value);
+        moves.emplace_back(PackedMove(fi, ti, flag), value);
     }
 
     /**
-     * Utility method for pieces that can 'slide' one or more spots.  Called
-     * by the move generation methods for rooks, bishops and queens.  Basically
-     * it is the same as addMoveIfValid(...) but it includes adding end spots
-     * occupied by an opponent piece that can be captured and returns true if
-     * the check for more spots in this 'slide' should continue or false if the
-     * slide has terminated.
+     * Utility method for pieces whose moves come straight from the attack tables.
+     * Called by the move generation methods for knights, rooks, bishops and queens.
+     * Every target is already known to be on the board and not occupied by our own
+     * side so no further checks are needed.
      *
      * @param moves Reference to the list of moves to add to
      * @param col The column on the board to move from
      * @param row The row on the board to move from
-     * @param x The column on the board to move to
-     * @param y The row on the board to move to
-     * @return true if the check for more 'slide' spots should
-     *         continue for this piece or false if the 'slide' has
-     *         completed by going off of the board or terminating
-     *         at a non-empty spot.
+     * @param targets The spots to move to
+     * @return nothing.  The specified list is updated to include a move to each target
      */
-    bool Board::addSlider(MoveList &moves, unsigned int const col, unsigned int const row,
-                          unsigned int const x, unsigned int const y) const {
-        if (!isValidSpot(x, y)) {
-            return false;
+    void Board::addMoves(MoveList &moves, unsigned int const col, unsigned int const row,
+                         Bitboard targets) const {
+        while (targets) {
+            unsigned int const ti = popLsb(targets);
+            moves.emplace_back(col, row, ti % 8, ti / 8, getValue(ti));
         }
-        if (!isEmpty(x + y * 8)) {
-            if (getSide(col + row * 8) == getSide(x + y * 8)) {
-                return false;
-            }
-            addMoveIfValid(moves, col, row, x, y);
-            return false;
-        }
-        addMoveIfValid(moves, col, row, x, y);
-        return true;
     }
 
     /**
@@ -528,20 +981,11 @@ namespace chess {
      * @return A new MoveList containing all possible moves a rook could make from the given
      * spot
      */
-    void Board::getRookMoves(MoveList &moves, unsigned int const col,
-                             unsigned int const row) const {
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col - offset, row)) break;
-        }
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col + offset, row)) break;
-        }
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col, row - offset)) break;
-        }
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col, row + offset)) break;
-        }
+    void Board::getRookMoves(MoveList &moves, unsigned int const col, unsigned int const row,
+                             Bitboard const allowed) const {
+        unsigned int const ndx = col + row * 8;
+        Bitboard const targets = rookAttacks(ndx, getOccupied()) & ~sideBits[getSide(ndx)];
+        addMoves(moves, col, row, targets & allowed);
     }
 
     /**
@@ -552,16 +996,11 @@ namespace chess {
      * @return A new MoveList containing all possible moves a knight could make from the given
      * spot
      */
-    void Board::getKnightMoves(MoveList &moves, unsigned int const col,
-                               unsigned int const row) const {
-        addMoveIfValid(moves, col, row, col - 1, row - 2);
-        addMoveIfValid(moves, col, row, col + 1, row - 2);
-        addMoveIfValid(moves, col, row, col - 1, row + 2);
-        addMoveIfValid(moves, col, row, col + 1, row + 2);
-        addMoveIfValid(moves, col, row, col - 2, row - 1);
-        addMoveIfValid(moves, col, row, col + 2, row - 1);
-        addMoveIfValid(moves, col, row, col - 2, row + 1);
-        addMoveIfValid(moves, col, row, col + 2, row + 1);
+    void Board::getKnightMoves(MoveList &moves, unsigned int const col, unsigned int const row,
+                               Bitboard const allowed) const {
+        unsigned int const ndx = col + row * 8;
+        Bitboard const targets = knightAttacks(ndx) & ~sideBits[getSide(ndx)];
+        addMoves(moves, col, row, targets & allowed);
     }
 
     /**
@@ -572,20 +1011,11 @@ namespace chess {
      * @return A new MoveList containing all possible moves a bishop could make from the given
      * spot
      */
-    void Board::getBishopMoves(MoveList &moves, unsigned int const col,
-                               unsigned int const row) const {
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col - offset, row - offset)) break;
-        }
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col + offset, row - offset)) break;
-        }
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col - offset, row + offset)) break;
-        }
-        for (unsigned int offset = 1; offset <= 7; offset++) {
-            if (!addSlider(moves, col, row, col + offset, row + offset)) break;
-        }
+    void Board::getBishopMoves(MoveList &moves, unsigned int const col, unsigned int const row,
+                               Bitboard const allowed) const {
+        unsigned int const ndx = col + row * 8;
+        Bitboard const targets = bishopAttacks(ndx, getOccupied()) & ~sideBits[getSide(ndx)];
+        addMoves(moves, col, row, targets & allowed);
     }
 
     /**
@@ -596,10 +1026,11 @@ namespace chess {
      * @return A new MoveList containing all possible moves a queen could make from the given
      * spot
      */
-    void Board::getQueenMoves(MoveList &moves, unsigned int const col,
-                              unsigned int const row) const {
-        getRookMoves(moves, col, row);
-        getBishopMoves(moves, col, row);
+    void Board::getQueenMoves(MoveList &moves, unsigned int const col, unsigned int const row,
+                              Bitboard const allowed) const {
+        unsigned int const ndx = col + row * 8;
+        Bitboard const targets = queenAttacks(ndx, getOccupied()) & ~sideBits[getSide(ndx)];
+        addMoves(moves, col, row, targets & allowed);
     }
 
     /**
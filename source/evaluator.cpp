@@ -34,17 +34,27 @@ namespace chess {
         int mobilityBonus = 3;
         int centerBonus = 5;
 
-        for (unsigned int ndx = 0; ndx < BOARD_SIZE; ndx++) {
-            Piece p = board.board[ndx];
-            int sideFactor = (getSide(p) == Black) ? -1 : 1;
+        for (Color side : {Black, White}) {
+            int const sideFactor = (side == Black) ? -1 : 1;
 
-            /// The score or 'identity property' of the board includes points for
-            /// all pieces the player has remaining.
-            score += (filter & material) ? sideFactor * materialEvaluator(p) : 0;
+            for (Piece type = Pawn; type <= King; type++) {
+                Bitboard pieces = board.getPieces(side, type);
 
-            /// The score or 'identity property' of the board includes points for
-            /// how close the remaining pieces are to the center of the board.
-            score += (filter & center) ? sideFactor * centerEvaluator(ndx, p) * centerBonus : 0;
+                /// The score or 'identity property' of the board includes points for
+                /// all pieces the player has remaining.
+                if (filter & material) {
+                    score += sideFactor * popCount(pieces) * materialEvaluator(type);
+                }
+
+                /// The score or 'identity property' of the board includes points for
+                /// how close the remaining pieces are to the center of the board.
+                if (filter & center) {
+                    while (pieces) {
+                        unsigned int const ndx = popLsb(pieces);
+                        score += sideFactor * centerEvaluator(ndx, type) * centerBonus;
+                    }
+                }
+            }
         }
 
         int sideFactor = (board.turn == Black) ? -1 : 1;
@@ -52,8 +62,8 @@ namespace chess {
         /// The score or 'identity property' of the board includes extra points for
         /// how many totals moves (mobility) the remaining pieces can make.
         if (filter & mobility) {
-            score += static_cast<int>(board.moves1.size()) * mobilityBonus * sideFactor;
-            score -= static_cast<int>(board.moves2.size()) * mobilityBonus * sideFactor;
+            score += static_cast<int>(board.getMoves1().size()) * mobilityBonus * sideFactor;
+            score -= static_cast<int>(board.getMoves2().size()) * mobilityBonus * sideFactor;
         }
 
         return score;
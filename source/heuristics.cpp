@@ -0,0 +1,58 @@
+//
+// heuristics.cpp
+//
+
+#include <heuristics.h>
+
+namespace chess {
+    void SearchHeuristics::clear() {
+        for (auto &slots : killers) slots.fill(PackedMove());
+        for (auto &from : history) {
+            for (auto &to : from) to.fill(0);
+        }
+        cutoffs = 0;
+        firstMoveCutoffs = 0;
+    }
+
+    void SearchHeuristics::addCutoff(Color const side, Move const &move, size_t const ply,
+                                     int const depth, int const moveNumber) {
+        cutoffs++;
+        if (moveNumber == 1) firstMoveCutoffs++;
+
+        if (move.isCapture() || move.isPromotion()) return;
+
+        if (ply < MaxPly) {
+            auto &slots = killers[ply];
+            if (!(slots[0] == move.getPacked())) {
+                for (size_t ndx = NumKillers - 1; ndx > 0; ndx--) slots[ndx] = slots[ndx - 1];
+                slots[0] = move.getPacked();
+            }
+        }
+
+        int &count = history[side][move.getFrom()][move.getTo()];
+        count += (depth > 0) ? depth * depth : 1;
+        if (count > HistoryMax) {
+            // halve the side's whole table so recent cutoffs outweigh old ones
+            for (auto &from : history[side]) {
+                for (int &value : from) value /= 2;
+            }
+        }
+    }
+
+    int SearchHeuristics::score(Color const side, Move const &move, size_t const ply) const {
+        if (ply < MaxPly) {
+            auto const &slots = killers[ply];
+            for (size_t ndx = 0; ndx < NumKillers; ndx++) {
+                if (slots[ndx] == move.getPacked()) return KillerScore - int(ndx);
+            }
+        }
+        return history[side][move.getFrom()][move.getTo()];
+    }
+
+    array<PackedMove, SearchHeuristics::NumKillers> const &SearchHeuristics::getKillers(
+        size_t const ply) const {
+        static array<PackedMove, NumKillers> const none{};
+        return (ply < MaxPly) ? killers[ply] : none;
+    }
+
+}  // namespace chess
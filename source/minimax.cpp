@@ -22,44 +22,218 @@
  */
 
 #include <evaluator.h>
+#include <heuristics.h>
 #include <minimax.h>
-#include <movecache.h>
+#include <threadpool.h>
+#include <transposition.h>
 
-#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
 #include <future>
 #include <mutex>
 
 namespace chess {
-    using std::async;
-    using std::deque;
+    using std::atomic;
+    using std::condition_variable;
+    using std::equal;
+    using std::find_if;
     using std::future;
-    using std::launch;
+    using std::lock_guard;
+    using std::max;
+    using std::memory_order_relaxed;
+    using std::min;
+    using std::remove_if;
+    using std::rotate;
+    using std::stable_sort;
     using std::thread;
+    using std::unique_lock;
     using std::chrono::duration;
     using std::chrono::steady_clock;
     using std::this_thread::yield;
 
-    mutex examinedMutex;
+    /// The moves left at a negamax(...) board that idle threads can join in searching
+    /// (useYbwc).  The board, window and node never change once the split point is made.
+    /// The rest is guarded by the pool's mutex, apart from cutoff which is read lock-free
+    /// by every search below the split point to see if it should give up.
+    struct SplitPoint {
+        Board const board;
+        SplitPoint const *const parent;  // the split point the board's own search is under
+        Minimax::SearchNode const node;
+        int const beta;
+        bool const wantLine;  // keep the best line of play y/N
 
-    // free-standing function to atomically update the number of moves evaluated
+        MoveList moves;  // the moves left to search, next first
+        size_t next{0};
+        int alpha;
+        int movesExamined{0};
+        int bestValue{MIN_VALUE};
+        Move bestMove;
+        MoveList line;  // the best line of play found, bestMove first
+        bool pruned{false};
+        int workers{0};  // the helpers searching here besides the board's own thread
+        atomic<bool> cutoff{false};
+
+        SplitPoint(Board const &b, SplitPoint const *p, Minimax::SearchNode const &n, int a,
+                   int bt, bool l)
+            : board(b), parent(p), node(n), beta(bt), wantLine(l), alpha(a) {}
+    };
+
+    /// The white-positive window a root split search's threads share (useSharedWindow).  As
+    /// each root move's score comes in the window is narrowed to scores that could still
+    /// tie or beat it, so the other threads only look for those.
+    struct RootWindow {
+        atomic<int> alpha;
+        atomic<int> beta;
+    };
+
+    /// The helper threads of a YBWC search and the split points they can join
+    struct SplitPool {
+        mutex lock;
+        condition_variable changed;  // a split point was made, finished with or left
+        vector<SplitPoint *> splits;
+        atomic<int> idle{0};  // the helpers waiting for a split point to join
+        bool stop{false};
+    };
+
+    // set on Lazy SMP helper threads to the flag that tells them to stop searching
+    static thread_local atomic<bool> const *stopSearch = nullptr;
+
+    // set on the threads of a YBWC search to its pool and to the split point being searched
+    static thread_local SplitPool *splitPool = nullptr;
+    static thread_local SplitPoint const *currentSplit = nullptr;
+
+    // set on the threads of a root split search with useSharedWindow to the window they share
+    static thread_local RootWindow const *rootWindow = nullptr;
+
+    // the number of boards this thread has cut off by the shared root window.  A board that
+    // sees it go up while its moves are searched has a partial score from below and so
+    // keeps nothing in the transposition table.
+    static thread_local unsigned long rootCuts = 0;
+
+    // the killer moves and history for the search running on each thread, kept apart so
+    // the threads never share or lock them
+    static thread_local SearchHeuristics heuristics;
+
+    // free-standing function to add to the number of moves evaluated on this thread's own
+    // counter.  Only this thread writes it so the add never waits on another thread.
     static void updateNumMoves(Minimax &agent, int delta) {
-        std::lock_guard<std::mutex> guard(examinedMutex);
-        agent.movesExamined += delta;
+        agent.nodeCounts[ThreadPool::threadSlot()].nodes.fetch_add(delta, memory_order_relaxed);
     }
 
-    /// free-standing function to see if move search thread has reached the time limit
-    static bool hasTimedOut(Minimax const &agent, int const currentDepth) {
+    /// free-standing function to see if the time allowed for the move search has run out
+    static bool isOutOfTime(Minimax const &agent) {
         if (agent.timeout == 0) {
             return false;
         }
-        if (currentDepth == agent.maxDepth) {
-            return false;
-        }  // always let the first set of moves complete
-        return (steady_clock::now() - agent.startTime).count() >= agent.timeout;
+        return duration<double>(steady_clock::now() - agent.startTime).count() >= agent.timeout;
+    }
+
+    /// free-standing function to see if this thread is a helper that has been told to stop
+    /// or a cutoff was made at a split point it is searching under
+    static bool isStopped() {
+        if (stopSearch != nullptr && stopSearch->load(memory_order_relaxed)) return true;
+        for (SplitPoint const *split = currentSplit; split != nullptr; split = split->parent) {
+            if (split->cutoff.load(memory_order_relaxed)) return true;
+        }
+        return false;
     }
 
-    Minimax::Minimax(int max_depth) : useThreads(false), useCache(false), best(true) {
-        acceptableRiskLevel = 0.25;
+    /**
+     * free-standing function to narrow a board's window to the root window shared by the
+     * threads of a root split search.  A side of the window is only narrowed while it stays
+     * short of the other side.  Past that the board can no longer change the root move's
+     * score, and it is cut off once its own best score shows it (useSharedWindow).  Each
+     * cut is counted in rootCuts.
+     *
+     * @param sign 1 for a window in white-positive terms, -1 for one in Black's terms
+     * @param maximize true if the board takes the highest score in the window's terms
+     * @param best the best score found at the board so far
+     * @param alpha the board's alpha, raised to the shared one if it can be
+     * @param beta the board's beta, lowered to the shared one if it can be
+     * @return true if the board should stop searching
+     */
+    static bool narrowToRoot(int const sign, bool const maximize, int const best, int &alpha,
+                             int &beta) {
+        if (rootWindow == nullptr) return false;
+
+        int const shareAlpha = rootWindow->alpha.load(memory_order_relaxed);
+        int const shareBeta = rootWindow->beta.load(memory_order_relaxed);
+        int const low = (sign > 0) ? shareAlpha : -shareBeta;
+        int const high = (sign > 0) ? shareBeta : -shareAlpha;
+        if (low > alpha) {
+            if (low < beta) {
+                alpha = low;
+            } else if (!maximize && best <= low) {
+                rootCuts++;
+                return true;
+            }
+        }
+        if (high < beta) {
+            if (high > alpha) {
+                beta = high;
+            } else if (maximize && best >= high) {
+                rootCuts++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// free-standing function to get the number of threads a parallel search should use
+    static unsigned int searchThreads(Minimax const &agent) {
+        if (agent.numThreads > 0) return agent.numThreads;
+        unsigned int const cores = thread::hardware_concurrency();
+        return (cores > agent.reserve) ? cores - agent.reserve : 1;
+    }
+
+    /// free-standing function to see if move search thread has reached the time limit or
+    /// been stopped.  Once it has every board still being searched is cut short.
+    static bool hasTimedOut(Minimax const &agent) { return isStopped() || isOutOfTime(agent); }
+
+    /// free-standing function to see if the side to move has any moves.  A board the move
+    /// picker will search (depth left) only needs to find one.  Any other board builds its
+    /// full list anyway, to walk it or for the evaluator's mobility score.
+    static bool hasMoves(Minimax const &agent, Board const &board, int const depth) {
+        return (agent.useMovePicker && depth > 0) ? board.hasLegalMove(board.turn)
+                                                  : !board.getMoves1().empty();
+    }
+
+    Minimax::Minimax(int max_depth)
+        : useThreads(false),
+          useLazySmp(false),
+          useCache(false),
+          useMovePicker(false),
+          best(true) {
+        cacheSize = 16;
+        useIterativeDeepening = false;
+        useNegamax = false;
+        useAspiration = false;
+        useNullMove = false;
+        useLateMoveReductions = false;
+        useKillers = false;
+        useSee = false;
+        useQuiescence = false;
+        quiescenceChecks = false;
+        useFutility = false;
+        useYbwc = false;
+        useSharedWindow = false;
+        numThreads = 0;
+        futilityMargin = 150;
+        reverseFutilityMargin = 120;
+        razorMargin = 300;
+        cutoffs = 0;
+        firstMoveCutoffs = 0;
+        nullMoveReduction = 2;
+        aspirationWindow = 75;
+        failHighs = 0;
+        failLows = 0;
+        lastValue = {0, 0};
+        lastHistory = {0, 0};
+        lastValid = {false, false};
+        rootHistory = 0;
         maxDepth = max_depth;
         extraChecks = false;
         movesExamined = 0L;
@@ -68,28 +242,60 @@ namespace chess {
         reserve = 0;
     }
 
+    long Minimax::countNodes() const {
+        long nodes = 0;
+        for (NodeCount const &count : nodeCounts) nodes += count.nodes.load(memory_order_relaxed);
+        return nodes;
+    }
+
+    int Minimax::lateMoveReduction(int const depth, int const moveNumber) {
+        static auto const reductions = []() {
+            // the first few moves (the best guesses) are never reduced
+            array<array<int, 64>, 64> table{};
+            for (int d = 1; d < 64; d++) {
+                for (int m = 4; m < 64; m++) {
+                    table[d][m] = int(0.75 + log(double(d)) * log(double(m)) / 2.25);
+                }
+            }
+            return table;
+        }();
+        return reductions[min(max(depth, 0), 63)][min(max(moveNumber, 0), 63)];
+    }
+
     Move Minimax::bestMove(Board const &board) {
         bool const maximize = (board.turn == White);
         best = BestMove(maximize);
         movesExamined = 0;
+        for (NodeCount &count : nodeCounts) count.nodes.store(0, memory_order_relaxed);
 
         // return immediately if there are 1 or 0 moves
-        if (board.moves1.size() <= 1) {
-            if (!board.moves1.empty()) {
-                best = BestMove(board.moves1[0], board.moves1[0].getValue());
-                updateNumMoves(*this, 1);
+        if (board.getMoves1().size() <= 1) {
+            if (!board.getMoves1().empty()) {
+                best = BestMove(board.getMoves1()[0], board.getMoves1()[0].getValue());
+                movesExamined = 1;
             }
             return best.move;
         }
 
         startTime = steady_clock::now();
 
-        // See if we have a cached move if we aren't in an end game situation
-        if (useCache && board.moves1.size() > 5) {
-            auto entry = cache.lookup(board);
-            if (entry.isValid(board)) {
-                movesExamined += entry.movesExamined;
-                return entry.move;
+        // See if this board was already searched as deep as we would search it now if we
+        // aren't in an end game situation.  The root is searched one ply deeper than the
+        // maxDepth passed to minmax(...) for each of its moves
+        if (useCache) {
+            if (cache.empty()) cache.resize(cacheSize);
+            cache.newSearch();
+
+            if (board.getMoves1().size() > 5) {
+                TTEntry const entry = cache.probe(board.getHash());
+                if (entry.isValid() && entry.bound == TTEntry::Exact && entry.depth > maxDepth) {
+                    MoveList const &moves = board.getMoves1();
+                    auto const found = find(moves.begin(), moves.end(), Move(entry.move));
+                    if (found != moves.end()) {
+                        best = BestMove(*found, entry.score);
+                        return best.move;
+                    }
+                }
             }
         }
 
@@ -103,80 +309,273 @@ namespace chess {
             }
         }
 
-        auto move = useThreads ? searchWithThreads(board, maximize, pieceMap)
-                               : searchWithNoThreads(board, maximize, pieceMap);
+        // The value of the last search for this side is the one to expect if it was of
+        // this same game a move ago.  The other side's last search is a ply shallower or
+        // deeper, and scores from odd and even numbers of plies can be far apart.
+        Color const side = board.turn;
+        bool const hasExpected
+            = lastValid[side] && board.history.size() == lastHistory[side] + 2;
+
+        rootHistory = board.history.size();
+        pv.clear();
+        heuristics.clear();
+
+        Move move;
+        if (useIterativeDeepening) {
+            move = searchIteratively(board, maximize, pieceMap);
+        } else {
+            move = searchRoot(board, board.getMoves1(), maximize, pieceMap, lastValue[side],
+                              hasExpected);
+        }
+        lastValid[side] = move.isValid();
+        lastValue[side] = best.value;
+        lastHistory[side] = board.history.size();
+
+        // every thread of the search is done with its counter by now
+        movesExamined = int(countNodes());
 
-        if (useCache && move.isValid(board)) {
-            cache.offer(board, move, board.turn, move.getValue(), movesExamined);
+        // count the cutoffs made on this thread (searchWithThreads adds the other threads')
+        cutoffs += heuristics.cutoffs;
+        firstMoveCutoffs += heuristics.firstMoveCutoffs;
+
+        if (useCache && move.isValid(board) && !hasTimedOut(*this)) {
+            cache.store(board.getHash(), move, move.getValue(), maxDepth + 1, TTEntry::Exact);
         }
 
         return move;
     }
 
-    ThreadResult threadFunc(ThreadArgs *pArgs) {
-        Move move = pArgs->move;
-        bool maximize = pArgs->maximize;
-        int depth = pArgs->depth;
-        Minimax &agent = pArgs->agent;
-        Board board = pArgs->board;
-        delete pArgs;
+    /// free-standing function to search one root move on a pool worker (useThreads), within
+    /// the window shared with the other root moves' threads if there is one
+    static ThreadResult threadFunc(Minimax &agent, Board board, Move move, int const depth,
+                                   bool const maximize, int const alpha, int const beta,
+                                   RootWindow *const window) {
+        heuristics.clear();
+        rootWindow = window;
 
         board.executeMove(move);
-        board.advanceTurn();
+        board.nextTurn();
         updateNumMoves(agent, 1);
 
-        int value = agent.minmax(board, MIN_VALUE, MAX_VALUE, depth, maximize);
-        return ThreadResult(value, move);
-    }
+        ThreadResult result;
+        result.move = move;
+        if (agent.useNegamax) {
+            // negamax scores are for the side to move, turned back to white-positive here
+            int const score = maximize ? agent.negamax(board, alpha, beta, depth, &result.line)
+                                       : -agent.negamax(board, -beta, -alpha, depth, &result.line);
+            result.value = score;
+        } else {
+            result.value = agent.minmax(board, alpha, beta, depth, maximize, &result.line);
+        }
+        result.cutoffs = heuristics.cutoffs;
+        result.firstMoveCutoffs = heuristics.firstMoveCutoffs;
+        rootWindow = nullptr;
 
-    Move Minimax::searchWithThreads(Board const &board, bool maximize, PieceMap & /* pieceMap */) {
-        vector<ThreadResult> threadResults;
-        deque<future<ThreadResult>> futures;
-
-        // This functor will wait on the first thread, process it,
-        // and remove it from the front of the deque.
-        auto waitForNextResult = [&board, &maximize, this, &futures]() {
-            if (!futures.empty()) {
-                auto const result = futures.front().get();
-                futures.pop_front();
-                if (result.isValid(board)) {
-                    if ((maximize && result.value > best.value)
-                        || (!maximize && result.value < best.value)) {
-                        best = BestMove(result.move, result.value);
-                    }
+        // A score inside the shared window is exact and the rest of the root moves now have
+        // to tie or beat it (maximize is the reply's side so the root is the other one)
+        if (window != nullptr) {
+            int const value = result.value;
+            if (!maximize) {
+                int low = window->alpha.load();
+                while (value - 1 > low && !window->alpha.compare_exchange_weak(low, value - 1)) {
+                }
+            } else {
+                int high = window->beta.load();
+                while (value + 1 < high && !window->beta.compare_exchange_weak(high, value + 1)) {
                 }
             }
-        };
+        }
+        return result;
+    }
 
-        unsigned int core_count = thread::hardware_concurrency();
+    Move Minimax::searchWithThreads(Board const &board, MoveList const &moves, bool maximize,
+                                    PieceMap & /* pieceMap */, int const alpha, int const beta) {
+        ThreadPool &pool = ThreadPool::shared();
+        pool.reserve(searchThreads(*this));
 
-        /// Number of cpu cores to leave out of the pool.
-        /// Note that if it is equal to or greater than
-        /// the number of available cores then the program
-        /// is effectively single threaded.
-        if (reserve > 0 && core_count >= reserve) {
-            core_count -= reserve;
+        RootWindow shared{{alpha}, {beta}};
+        RootWindow *const window = useSharedWindow ? &shared : nullptr;
+
+        // The pool may have more workers than this search is to use, left from an earlier
+        // one, so only searchThreads(...) tasks are queued and they take the moves in turn
+        vector<ThreadResult> results(moves.size());
+        atomic<size_t> next{0};
+        vector<future<void>> futures;
+        unsigned int const tasks = min(searchThreads(*this), unsigned(moves.size()));
+        for (unsigned int ndx = 0; ndx < tasks; ndx++) {
+            futures.emplace_back(
+                pool.submit([this, &board, &moves, &results, &next, maximize, alpha, beta,
+                             window]() {
+                    for (size_t m = next++; m < moves.size(); m = next++) {
+                        results[m] = threadFunc(*this, board, moves[m], maxDepth, !maximize,
+                                                alpha, beta, window);
+                    }
+                }));
         }
+        for (auto &pending : futures) pending.get();
+
+        // take the results in the order the moves were given so ties go to the earlier move
+        MoveList bestLine;
+        for (ThreadResult const &result : results) {
+            cutoffs += result.cutoffs;
+            firstMoveCutoffs += result.firstMoveCutoffs;
+
+            // with a shared window a score that didn't get inside it is only a bound, and
+            // some other root move is at least as good
+            bool const bounded = maximize ? (result.value <= shared.alpha && shared.alpha > alpha)
+                                          : (result.value >= shared.beta && shared.beta < beta);
+            if (bounded) continue;
 
-        for (Move const &m : board.moves1) {
-            if (reserve > 0) {
-                // brain-dead implementation to limit total cpu load
-                while (futures.size() > core_count) {
-                    yield();
-                    waitForNextResult();
+            if (result.isValid(board)) {
+                if ((maximize && result.value > best.value)
+                    || (!maximize && result.value < best.value)) {
+                    best = BestMove(result.move, result.value);
+                    bestLine = result.line;
                 }
             }
-            futures.emplace_back(future<ThreadResult>(async(
-                launch::async, threadFunc, new ThreadArgs(board, m, *this, maxDepth, !maximize))));
         }
 
-        while (!futures.empty()) {
-            yield();
-            waitForNextResult();
+        pv.clear();
+        if (best.move.isValid()) {
+            pv.push_back(best.move);
+            for (Move const &move : bestLine) pv.push_back(move);
         }
         return best.move;
     }
 
+    /**
+     * One Lazy SMP helper: search every root move with the full window, starting at the
+     * given one, until done or told to stop.  Only the transposition table entries and the
+     * counts are kept.
+     *
+     */
+    static ThreadResult helperFunc(Minimax &agent, Board board, MoveList moves, size_t const first,
+                                   int const depth, bool const maximize,
+                                   atomic<bool> const &stop) {
+        stopSearch = &stop;
+        heuristics.clear();
+
+        rotate(moves.begin(), moves.begin() + long(first), moves.end());
+        for (Move &move : moves) {
+            if (isStopped()) break;
+
+            MoveUndo const undo = board.executeMove(move);
+            board.nextTurn();
+            updateNumMoves(agent, 1);
+            if (agent.useNegamax) {
+                agent.negamax(board, MIN_VALUE, MAX_VALUE, depth);
+            } else {
+                agent.minmax(board, MIN_VALUE, MAX_VALUE, depth, !maximize);
+            }
+            board.undoMove(move, undo);
+        }
+
+        ThreadResult result;
+        result.cutoffs = heuristics.cutoffs;
+        result.firstMoveCutoffs = heuristics.firstMoveCutoffs;
+        stopSearch = nullptr;
+        return result;
+    }
+
+    Move Minimax::searchLazySmp(Board const &board, MoveList const &moves, bool const maximize,
+                                PieceMap &pieceMap, int const alpha, int const beta) {
+        unsigned int const helpers = searchThreads(*this) - 1;  // this thread is one of them
+
+        ThreadPool &pool = ThreadPool::shared();
+        pool.reserve(helpers);
+
+        atomic<bool> stop{false};
+        vector<future<ThreadResult>> futures;
+        for (unsigned int ndx = 0; ndx < helpers && !moves.empty(); ndx++) {
+            size_t const first = (ndx + 1) % moves.size();
+            int const depth = maxDepth + int(ndx % 2);
+            futures.emplace_back(
+                pool.submit([this, &board, &moves, first, depth, maximize, &stop]() {
+                    return helperFunc(*this, board, moves, first, depth, maximize, stop);
+                }));
+        }
+
+        Move const move = searchWithNoThreads(board, moves, maximize, pieceMap, alpha, beta);
+
+        stop = true;
+        for (auto &helper : futures) {
+            ThreadResult const result = helper.get();
+            cutoffs += result.cutoffs;
+            firstMoveCutoffs += result.firstMoveCutoffs;
+        }
+        return move;
+    }
+
+    /**
+     * One YBWC helper: join split points as they are made until the search is done.  Only
+     * the counts are kept, the results go to the split points.
+     *
+     */
+    static ThreadResult ybwcHelper(Minimax &agent, SplitPool &pool) {
+        splitPool = &pool;
+        heuristics.clear();
+
+        unique_lock<mutex> guard(pool.lock);
+        while (!pool.stop) {
+            auto const open = find_if(pool.splits.begin(), pool.splits.end(),
+                                      [](SplitPoint const *split) {
+                                          return split->next < split->moves.size()
+                                                 && !split->cutoff.load(memory_order_relaxed);
+                                      });
+            if (open == pool.splits.end()) {
+                pool.idle++;
+                pool.changed.wait(guard);
+                pool.idle--;
+                continue;
+            }
+
+            SplitPoint &split = **open;
+            split.workers++;
+            guard.unlock();
+            agent.searchSplit(split);
+            guard.lock();
+            split.workers--;
+            pool.changed.notify_all();
+        }
+
+        ThreadResult result;
+        result.cutoffs = heuristics.cutoffs;
+        result.firstMoveCutoffs = heuristics.firstMoveCutoffs;
+        splitPool = nullptr;
+        return result;
+    }
+
+    Move Minimax::searchYbwc(Board const &board, MoveList const &moves, bool const maximize,
+                             PieceMap &pieceMap, int const alpha, int const beta) {
+        unsigned int const helpers = searchThreads(*this) - 1;  // this thread is one of them
+
+        ThreadPool &workers = ThreadPool::shared();
+        workers.reserve(helpers);
+
+        SplitPool pool;
+        vector<future<ThreadResult>> futures;
+        for (unsigned int ndx = 0; ndx < helpers; ndx++) {
+            futures.emplace_back(
+                workers.submit([this, &pool]() { return ybwcHelper(*this, pool); }));
+        }
+
+        splitPool = &pool;
+        Move const move = searchWithNoThreads(board, moves, maximize, pieceMap, alpha, beta);
+        splitPool = nullptr;
+
+        {
+            lock_guard<mutex> guard(pool.lock);
+            pool.stop = true;
+        }
+        pool.changed.notify_all();
+        for (auto &helper : futures) {
+            ThreadResult const result = helper.get();
+            cutoffs += result.cutoffs;
+            firstMoveCutoffs += result.firstMoveCutoffs;
+        }
+        return move;
+    }
+
     /**
      * Iterate over all available moves for the current player and decide which move is the best.
      * This executes on the current thread and is a blocking call.
@@ -185,28 +584,145 @@ namespace chess {
      * @param pieceMap board pieces mapped by type and side
      * @return the best move for this board
      */
-    Move Minimax::searchWithNoThreads(Board const &board, bool maximize,
-                                      PieceMap & /* pieceMap */) {
-        for (Move move : board.moves1) {
-            if (hasTimedOut(*this, maxDepth)) return best.move;
-
-            Board currentBoard(board);
-            currentBoard.executeMove(move);
-            currentBoard.advanceTurn();
-            movesExamined++;
+    Move Minimax::searchWithNoThreads(Board const &board, MoveList const &moves, bool maximize,
+                                      PieceMap & /* pieceMap */, int const alpha,
+                                      int const beta) {
+        // every move is made and then taken back on this one working copy of the board
+        Board currentBoard(board);
+        MoveList line;
+        MoveList bestLine;
+
+        for (Move move : moves) {
+            // at least one move is searched so there is always one to make
+            if (best.isValid() && hasTimedOut(*this)) break;
 
-            int lookAheadVal = minmax(currentBoard, MIN_VALUE, MAX_VALUE, maxDepth, !maximize);
+            MoveUndo const undo = currentBoard.executeMove(move);
+            currentBoard.nextTurn();
+            updateNumMoves(*this, 1);
+
+            int lookAheadVal;
+            if (useNegamax) {
+                // Principal variation search at the root: once we have a best move the rest
+                // only need to prove they are no better with a null window around it, and
+                // are searched again with the full window if one is.  Scores are for our
+                // side here and turned back to white-positive ones to compare them below.
+                int const sign = maximize ? 1 : -1;
+                int const low = maximize ? alpha : -beta;
+                int const high = maximize ? beta : -alpha;
+                int score;
+                if (best.isValid()) {
+                    int const bound = max(low, sign * best.value);
+                    score = -negamax(currentBoard, -bound - 1, -bound, maxDepth, &line);
+                    if (score > bound && score < high) {
+                        score = -negamax(currentBoard, -high, -bound, maxDepth, &line);
+                    }
+                } else {
+                    score = -negamax(currentBoard, -high, -low, maxDepth, &line);
+                }
+                lookAheadVal = sign * score;
+            } else {
+                lookAheadVal = minmax(currentBoard, alpha, beta, maxDepth, !maximize, &line);
+            }
+            currentBoard.undoMove(move, undo);
 
             if ((maximize && lookAheadVal > best.value)
                 || (!maximize && lookAheadVal < best.value)) {
                 best.value = lookAheadVal;
                 best.move = move;
                 best.move.setValue(best.value);
+                bestLine = line;
             }
         }
+
+        pv.clear();
+        if (best.move.isValid()) {
+            pv.push_back(best.move);
+            for (Move const &move : bestLine) pv.push_back(move);
+        }
         return best.move;
     }
 
+    Move Minimax::searchRoot(Board const &board, MoveList const &moves, bool const maximize,
+                             PieceMap &pieceMap, int const expected, bool const hasExpected) {
+        int delta = aspirationWindow;
+        int alpha = MIN_VALUE;
+        int beta = MAX_VALUE;
+        if (useAspiration && hasExpected && delta > 0) {
+            alpha = max(MIN_VALUE, expected - delta);
+            beta = min(MAX_VALUE, expected + delta);
+        }
+
+        while (true) {
+            best = BestMove(maximize);
+            Move move;
+            if (useLazySmp) {
+                move = searchLazySmp(board, moves, maximize, pieceMap, alpha, beta);
+            } else if (useYbwc) {
+                move = searchYbwc(board, moves, maximize, pieceMap, alpha, beta);
+            } else if (useThreads) {
+                move = searchWithThreads(board, moves, maximize, pieceMap, alpha, beta);
+            } else {
+                move = searchWithNoThreads(board, moves, maximize, pieceMap, alpha, beta);
+            }
+
+            // A score on or outside the edge of the window only bounds the true one.  Which
+            // edge is the low one depends on whose turn it is.
+            bool const belowAlpha = alpha > MIN_VALUE && best.value <= alpha;
+            bool const aboveBeta = beta < MAX_VALUE && best.value >= beta;
+            if ((!belowAlpha && !aboveBeta) || isOutOfTime(*this)) return move;
+
+            if (belowAlpha) {
+                (maximize ? failLows : failHighs)++;
+                alpha = (alpha - MIN_VALUE > delta) ? alpha - delta : MIN_VALUE;
+            } else {
+                (maximize ? failHighs : failLows)++;
+                beta = (MAX_VALUE - beta > delta) ? beta + delta : MAX_VALUE;
+            }
+            delta = min(MAX_VALUE, delta * 2);
+        }
+    }
+
+    Move Minimax::searchIteratively(Board const &board, bool const maximize,
+                                    PieceMap &pieceMap) {
+        int const finalDepth = maxDepth;
+        MoveList moves = board.getMoves1();
+        Move result;
+
+        // the values of the last two iterations, the older first.  Scores from odd and even
+        // numbers of plies can be far apart so the one two iterations back is the expected one
+        array<int, 2> values{};
+        array<bool, 2> valid{false, false};
+
+        // maxDepth 0 searches 1 ply so each iteration searches one more ply than the last
+        for (maxDepth = 0; maxDepth <= finalDepth; maxDepth++) {
+            if (result.isValid() && isOutOfTime(*this)) break;
+
+            MoveList const lastPv = pv;
+            Move const move = searchRoot(board, moves, maximize, pieceMap, values[0], valid[0]);
+
+            // A later iteration that ran out of time was cut short and only has partial
+            // results so we keep the last complete one.  The first is kept regardless so
+            // there is a move to make.
+            if (result.isValid() && isOutOfTime(*this)) {
+                pv = lastPv;
+                break;
+            }
+            result = move;
+            values = {values[1], best.value};
+            valid = {valid[1], result.isValid()};
+
+            // search this iteration's best move first in the next one
+            auto const found = find(moves.begin(), moves.end(), result);
+            if (found != moves.end()) {
+                rotate(moves.begin(), found, found + 1);
+            }
+        }
+
+        maxDepth = finalDepth;
+        best = BestMove(result, result.getValue());
+        return result;
+    }
+
     //    void unused_int(int /* unused */) {}
     //    void unused_bool(bool /* unused */) {}
 
@@ -225,101 +741,120 @@ namespace chess {
      * @param maximize  true if we are looking for a board state with the maximum score (white
      * player's turn) false if we are looking for a board state with the lowest score (black
      * player's turn)
+     * @param line      if not nullptr, set to the best line of play found from this board
      * @return the best score this move (and all consequential response/exchanges up to the allowed
      *         look-ahead depth or time limit for searching).
      */
     int Minimax::minmax(Board &origBoard, int alpha, int beta, int const depth,
-                        bool const maximize) {
+                        bool const maximize, MoveList *const line) {
         BestMove mmBest(maximize);
         int value = mmBest.value;
-        bool gotCacheHit;
-        int cachedValue = value;
-        Entry check;
+        if (line != nullptr) line->clear();
+        narrowToRoot(1, maximize, mmBest.value, alpha, beta);
 
-        for (auto &move : origBoard.moves1) {
-            yield();
-            if (depth <= 0) {
-                bool ourLastMoveWasCapture = false;
-                if (origBoard.history.size() >= 2) {
-                    Move &ourLastMove = origBoard.history[origBoard.history.size() - 2];
-                    ourLastMoveWasCapture = ourLastMove.isCapture();
-                }
-                if (!ourLastMoveWasCapture || depth <= qMaxDepth) {
-                    updateNumMoves(*this, mmBest.movesExamined);
-                    return Evaluator::evaluate(origBoard);
-                }
+        // Past the search depth we evaluate the board as it is unless our last move was
+        // a capture and we still have quiescent depth left to see what it led to, or with
+        // useQuiescence, leave it to the captures-only quiescence search
+        if (depth <= 0 && hasMoves(*this, origBoard, depth)) {
+            if (useQuiescence) {
+                return maximize ? quiesce(origBoard, alpha, beta)
+                                : -quiesce(origBoard, -beta, -alpha);
             }
-
-            if (hasTimedOut(*this, depth)) {
-                return mmBest.isValid(origBoard) ? mmBest.value : 0;
+            bool ourLastMoveWasCapture = false;
+            if (origBoard.history.size() >= 2) {
+                Move &ourLastMove = origBoard.history[origBoard.history.size() - 2];
+                ourLastMoveWasCapture = ourLastMove.isCapture();
             }
+            if (!ourLastMoveWasCapture || depth <= qMaxDepth) {
+                updateNumMoves(*this, mmBest.movesExamined);
+                return Evaluator::evaluate(origBoard);
+            }
+        }
 
-            ///////////////////////////////////////////////////////////////////
-            // Before we try to find our own best move for this board state, see
-            // if one is already cached:
-
-            gotCacheHit = false;
-            check = Entry();
-
-            // We force moves to be manually evaluated via minmax when we get down to the end game.
-            if (useCache && origBoard.moves1.size() > 5) {
-                check = cache.lookup(origBoard);
-                if (check.isValid()) {
-                    gotCacheHit = true;
-                    value = check.getValue();
-                    cachedValue = value;
-                    mmBest.move = check.move;
-                    mmBest.value = value;
-                    mmBest.move.setValue(value);
-                    mmBest.movesExamined += check.movesExamined;
+        ///////////////////////////////////////////////////////////////////
+        // See if this board has been searched before.  An entry searched at least as deep
+        // can narrow the window or end the search here, and any entry's best move is
+        // tried first.
+        HashKey const key = origBoard.getHash();
+        int const alphaOrig = alpha;
+        int const betaOrig = beta;
+        Move hashMove;
 
-                    if (check.getRisk() > acceptableRiskLevel) {
-                        // The risk is too high so we will do this manually and increase the count
-                        // of how many times we have re-evaluated this move for this board
-                        cache.increaseMoveUsedCount(origBoard, origBoard.turn);
-                        check = Entry();
-                    }
+        if (useCache) {
+            TTEntry const entry = cache.probe(key);
+            if (entry.isValid()) {
+                hashMove = Move(entry.move);
+                if (entry.depth >= depth) {
+                    if (entry.bound == TTEntry::Exact) return entry.score;
+                    if (entry.bound == TTEntry::Lower && entry.score > alpha) alpha = entry.score;
+                    if (entry.bound == TTEntry::Upper && entry.score < beta) beta = entry.score;
+                    if (alpha >= beta) return entry.score;
                 }
             }
+        }
 
-            if (!check.isValid()) {
-                // We did not get a cached move so evaluate this one fresh
+        // While we are still following the last iteration's principal variation its next
+        // move is the best guess we have, better than whatever the table kept.  Lazy SMP
+        // helpers leave it alone: the main thread rewrites it when its search is done.
+        size_t const ply = origBoard.history.size() - rootHistory;
+        if (stopSearch == nullptr && ply < pv.size()
+            && equal(pv.begin(), pv.begin() + ply, origBoard.history.end() - ply)) {
+            hashMove = pv[ply];
+        }
 
-                Board currentBoard(origBoard);
-                currentBoard.executeMove(move);
-                currentBoard.advanceTurn();
-                mmBest.movesExamined++;
+        // The searches below make and take back each move on origBoard itself which
+        // replaces its move lists so we walk our own copy of the list, or with the
+        // move picker, let it generate the moves in stages as they are needed
+        SearchHeuristics const *const ordering = useKillers ? &heuristics : nullptr;
+        MovePicker picker = useMovePicker
+                                ? MovePicker(origBoard, hashMove, ordering, ply, useSee)
+                                : MovePicker(origBoard.getMoves1(), hashMove, ordering,
+                                             origBoard.turn, ply);
 
-                // See if the move we just made leaves the other player with no moves
-                // and if so, return it as the best value we'll ever see on this search:
-                if (currentBoard.moves1.empty()) {
-                    mmBest.move = move;
-                    mmBest.value = maximize ? MAX_VALUE - (100 - depth) : MIN_VALUE + (100 - depth);
-                    break;
-                }
+        unsigned long const cutsBefore = rootCuts;
+        Move move;
+        MoveList childLine;
+        while (picker.next(move)) {
+            yield();
 
-                // The recursive minimax step
-                // While we have the depth keep looking ahead to see what this move accomplishes
-                value = minmax(currentBoard, alpha, beta, depth - 1, !maximize);
+            if (hasTimedOut(*this)) break;
 
-                // See if this move is better than any we've seen for this board:
-                //
-                if ((!maximize && value < mmBest.value) || (maximize && value > mmBest.value)) {
-                    mmBest.value = value;
-                    mmBest.move = move;
-                    mmBest.move.setValue(value);
+            // another root move's thread may have found a score this board can't change
+            if (narrowToRoot(1, maximize, mmBest.value, alpha, beta)) break;
 
-                    if (useCache) {
-                        cache.offer(origBoard, move, origBoard.turn, value, mmBest.movesExamined);
-                    }
+            MoveUndo const undo = origBoard.executeMove(move);
+            origBoard.nextTurn();
+            mmBest.movesExamined++;
+
+            // See if the move we just made leaves the other player with no moves
+            // and if so, return it as the best value we'll ever see on this search:
+            if (!hasMoves(*this, origBoard, depth - 1)) {
+                origBoard.undoMove(move, undo);
+                mmBest.move = move;
+                mmBest.value = maximize ? MAX_VALUE - (100 - depth) : MIN_VALUE + (100 - depth);
+                if (line != nullptr) {
+                    line->clear();
+                    line->push_back(move);
                 }
+                break;
+            }
 
-                // See if we had a cache hit but evaluated it anyway, and whether this improved the
-                // existing move
-                if (gotCacheHit) {
-                    if ((maximize && value > cachedValue) || (!maximize && value < cachedValue)) {
-                        cache.increaseMoveImprovedCount(origBoard, origBoard.turn);
-                    }
+            // The recursive minimax step
+            // While we have the depth keep looking ahead to see what this move accomplishes
+            value = minmax(origBoard, alpha, beta, depth - 1, !maximize,
+                           (line != nullptr) ? &childLine : nullptr);
+            origBoard.undoMove(move, undo);
+
+            // See if this move is better than any we've seen for this board:
+            //
+            if ((!maximize && value < mmBest.value) || (maximize && value > mmBest.value)) {
+                mmBest.value = value;
+                mmBest.move = move;
+                mmBest.move.setValue(value);
+                if (line != nullptr) {
+                    line->clear();
+                    line->push_back(move);
+                    for (Move const &next : childLine) line->push_back(next);
                 }
             }
 
@@ -333,17 +868,463 @@ namespace chess {
                 beta = (value < beta) ? value : beta;
             }
             if (alpha >= beta) {
+                heuristics.addCutoff(origBoard.turn, move, ply, depth, mmBest.movesExamined);
                 break;
             }
         }
 
+        // Once the time is up or the search is stopped any of the boards below here may
+        // have been cut short, so this one's value is partial and isn't kept.  Neither is
+        // ever undone during a search so a board cut short below here still shows it now.
+        bool const aborted = hasTimedOut(*this);
+        if (aborted) {
+            return mmBest.isValid(origBoard) ? mmBest.value : 0;
+        }
+
         updateNumMoves(*this, mmBest.movesExamined);
 
+        // Keep what we found along with what it says about the board's true value.  A board
+        // cut off by the shared root window, here or below, didn't search all of its moves
+        // against its own window so its score can't be labelled by it and isn't kept.
+        bool const cutByRoot = rootCuts != cutsBefore;
+        if (useCache && !cutByRoot && mmBest.move.isValid()) {
+            // scores outside the shared root window (as it is now) are only bounds
+            int alphaEdge = alphaOrig;
+            int betaEdge = betaOrig;
+            narrowToRoot(1, maximize, BestMove(maximize).value, alphaEdge, betaEdge);
+
+            unsigned int bound = TTEntry::Exact;
+            if (mmBest.value <= alphaEdge) {
+                bound = TTEntry::Upper;
+            } else if (mmBest.value >= betaEdge) {
+                bound = TTEntry::Lower;
+            }
+            cache.store(key, mmBest.move, mmBest.value, depth, bound);
+        }
+
         return mmBest.value;
     }
 
-    ThreadArgs::ThreadArgs(Board const &b, Move const &m, Minimax &mm, int d, bool max)
-        : board(b), move(m), agent(mm), depth(d), maximize(max) {}
+    /**
+     * Negamax with principal variation search.  It walks the same moves in the same order as
+     * minmax(...) and returns the same values (negated for Black) but with far fewer nodes
+     * searched.
+     *
+     */
+    int Minimax::negamax(Board &origBoard, int alpha, int beta, int const depth,
+                         MoveList *const line, bool const allowNullMove) {
+        // the sign that turns white-positive scores into scores for the side to move
+        int const sign = (origBoard.turn == White) ? 1 : -1;
+        BestMove nmBest(true);
+        if (line != nullptr) line->clear();
+        narrowToRoot(sign, true, nmBest.value, alpha, beta);
+
+        // Past the search depth we evaluate the board as it is unless our last move was
+        // a capture and we still have quiescent depth left to see what it led to
+        if (depth <= 0 && hasMoves(*this, origBoard, depth)) {
+            if (useQuiescence) return quiesce(origBoard, alpha, beta);
+            bool ourLastMoveWasCapture = false;
+            if (origBoard.history.size() >= 2) {
+                Move &ourLastMove = origBoard.history[origBoard.history.size() - 2];
+                ourLastMoveWasCapture = ourLastMove.isCapture();
+            }
+            if (!ourLastMoveWasCapture || depth <= qMaxDepth) {
+                updateNumMoves(*this, nmBest.movesExamined);
+                return sign * Evaluator::evaluate(origBoard);
+            }
+        }
+
+        // The table keeps white-positive scores so a bound for Black points the other way
+        HashKey const key = origBoard.getHash();
+        int const alphaOrig = alpha;
+        int const betaOrig = beta;
+        Move hashMove;
+
+        if (useCache) {
+            TTEntry const entry = cache.probe(key);
+            if (entry.isValid()) {
+                hashMove = Move(entry.move);
+                if (entry.depth >= depth) {
+                    int const score = sign * entry.score;
+                    unsigned int bound = entry.bound;
+                    if (sign < 0 && bound != TTEntry::Exact) {
+                        bound = (bound == TTEntry::Lower) ? TTEntry::Upper : TTEntry::Lower;
+                    }
+                    if (bound == TTEntry::Exact) return score;
+                    if (bound == TTEntry::Lower && score > alpha) alpha = score;
+                    if (bound == TTEntry::Upper && score < beta) beta = score;
+                    if (alpha >= beta) return score;
+                }
+            }
+        }
+
+        size_t const ply = origBoard.history.size() - rootHistory;
+        if (stopSearch == nullptr && ply < pv.size()
+            && equal(pv.begin(), pv.begin() + ply, origBoard.history.end() - ply)) {
+            hashMove = pv[ply];
+        }
+
+        SearchHeuristics const *const ordering = useKillers ? &heuristics : nullptr;
+        MovePicker picker = useMovePicker
+                                ? MovePicker(origBoard, hashMove, ordering, ply, useSee)
+                                : MovePicker(origBoard.getMoves1(), hashMove, ordering,
+                                             origBoard.turn, ply);
+
+        // Frontier pruning off the principal variation when not in check and not near a mate.
+        // Reverse futility: a board this far above beta won't fall below it in the few
+        // plies left.  Razoring: one this far below alpha is only worth the captures that
+        // might bring it back, so the quiescence search decides.
+        bool const inCheck = (useLateMoveReductions || useSee || useFutility)
+                             && origBoard.kingIsInCheck(origBoard.turn);
+        bool const frontier = useFutility && depth > 0 && depth <= FutilityDepth
+                              && betaOrig - alphaOrig == 1 && !inCheck
+                              && alpha > MIN_VALUE + 100 && beta < MAX_VALUE - 100;
+        int staticEval = 0;
+        if (frontier) {
+            staticEval = sign * Evaluator::evaluate(origBoard);
+            if (staticEval - reverseFutilityMargin * depth >= beta) {
+                return staticEval - reverseFutilityMargin * depth;
+            }
+            if (staticEval + razorMargin * depth <= alpha) {
+                int const value = quiesce(origBoard, alpha, beta);
+                if (value <= alpha) return value;
+            }
+        }
+
+        // Null move pruning: a move is nearly always better than passing so if passing
+        // still fails high this board would too.  Only tried off the principal variation
+        // (a null window), not in check, not right after another null move and not with
+        // only pawns left.  With few pieces left passing may really be best (zugzwang) so a
+        // fail high there is only trusted once a normal search to the same depth agrees.
+        if (useNullMove && allowNullMove && depth > nullMoveReduction
+            && betaOrig - alphaOrig == 1 && beta < MAX_VALUE - 100
+            && origBoard.getNonPawnPieces(origBoard.turn) != 0
+            && !origBoard.kingIsInCheck(origBoard.turn)) {
+            int const reduced = depth - 1 - nullMoveReduction;
+            MoveUndo const undo = origBoard.executeNullMove();
+            origBoard.nextTurn();
+            int const score = -negamax(origBoard, -beta, -beta + 1, reduced, nullptr, false);
+            origBoard.undoNullMove(undo);
+
+            if (score >= beta && !hasTimedOut(*this)) {
+                bool verified = popCount(origBoard.getNonPawnPieces(origBoard.turn)) > 2;
+                if (!verified) {
+                    verified = negamax(origBoard, beta - 1, beta, reduced, nullptr, false) >= beta;
+                }
+                // a mate found by passing isn't a mate we can play
+                if (verified) return (score >= MAX_VALUE - 100) ? beta : score;
+            }
+        }
+
+        // Futility pruning: quiet moves can't lift a frontier board this far below alpha
+        SearchNode const node{depth, inCheck, betaOrig - alphaOrig == 1,
+                              frontier && staticEval + futilityMargin * depth <= alpha};
+        bool pruned = false;
+        unsigned long const cutsBefore = rootCuts;
+        Move move;
+        MoveList childLine;
+        MoveList *const childLinePtr = (line != nullptr) ? &childLine : nullptr;
+        while (picker.next(move)) {
+            yield();
+
+            if (hasTimedOut(*this)) break;
+
+            if (narrowToRoot(sign, true, nmBest.value, alpha, beta)) break;
+
+            // Young brothers wait: once the first move is searched the rest are split
+            // between this thread and any helpers that are idle
+            if (splitPool != nullptr && depth >= SplitDepth && nmBest.movesExamined > 0
+                && splitPool->idle > 0) {
+                SplitPoint split(origBoard, currentSplit, node, alpha, beta, line != nullptr);
+                do {
+                    split.moves.push_back(move);
+                } while (picker.next(move));
+                split.movesExamined = nmBest.movesExamined;
+                split.bestValue = nmBest.value;
+                split.bestMove = nmBest.move;
+
+                {
+                    lock_guard<mutex> guard(splitPool->lock);
+                    splitPool->splits.push_back(&split);
+                }
+                splitPool->changed.notify_all();
+                searchSplit(split);
+
+                // no one else may join, and the ones that did have to finish
+                unique_lock<mutex> guard(splitPool->lock);
+                splitPool->splits.erase(
+                    find(splitPool->splits.begin(), splitPool->splits.end(), &split));
+                splitPool->changed.wait(guard, [&split]() { return split.workers == 0; });
+
+                pruned = pruned || split.pruned;
+                nmBest.movesExamined = split.movesExamined;
+                if (!(split.bestMove == nmBest.move)) {
+                    nmBest.value = split.bestValue;
+                    nmBest.move = split.bestMove;
+                    nmBest.move.setValue(sign * nmBest.value);
+                    if (line != nullptr) *line = split.line;
+                }
+                break;
+            }
+
+            int value = 0;
+            MoveOutcome const outcome = negamaxMove(origBoard, move, alpha, beta,
+                                                    nmBest.movesExamined + 1, node, value,
+                                                    childLinePtr);
+            if (outcome == MoveOutcome::Pruned) {
+                pruned = true;
+                continue;
+            }
+            nmBest.movesExamined++;
+
+            // A move that leaves the other player with no moves is the best we'll ever see
+            if (value > nmBest.value || outcome == MoveOutcome::Mate) {
+                nmBest.value = value;
+                nmBest.move = move;
+                nmBest.move.setValue(sign * value);
+                if (line != nullptr) {
+                    line->clear();
+                    line->push_back(move);
+                    for (Move const &next : childLine) line->push_back(next);
+                }
+            }
+            if (outcome == MoveOutcome::Mate) break;
+
+            if (value > alpha) alpha = value;
+            if (alpha >= beta) {
+                heuristics.addCutoff(origBoard.turn, move, ply, depth, nmBest.movesExamined);
+                break;
+            }
+        }
+
+        // partial results (see minmax(...)) aren't kept
+        bool const aborted = hasTimedOut(*this);
+        if (aborted) {
+            return nmBest.isValid(origBoard) ? nmBest.value : 0;
+        }
+
+        // every move was a losing capture so we stop here and take the board as it is
+        if (pruned && nmBest.movesExamined == 0) {
+            return sign * Evaluator::evaluate(origBoard);
+        }
+
+        updateNumMoves(*this, nmBest.movesExamined);
+
+        // as in minmax(...) a board cut off by the shared root window, here or below, isn't kept
+        bool const cutByRoot = rootCuts != cutsBefore;
+        if (useCache && !cutByRoot && nmBest.move.isValid()) {
+            int alphaEdge = alphaOrig;
+            int betaEdge = betaOrig;
+            narrowToRoot(sign, true, MIN_VALUE, alphaEdge, betaEdge);
+
+            unsigned int bound = TTEntry::Exact;
+            if (nmBest.value <= alphaEdge) {
+                bound = (sign > 0) ? TTEntry::Upper : TTEntry::Lower;
+            } else if (nmBest.value >= betaEdge) {
+                bound = (sign > 0) ? TTEntry::Lower : TTEntry::Upper;
+            }
+            cache.store(key, nmBest.move, sign * nmBest.value, depth, bound);
+        }
+
+        return nmBest.value;
+    }
+
+    Minimax::MoveOutcome Minimax::negamaxMove(Board &board, Move &move, int const alpha,
+                                              int const beta, int const moveNumber,
+                                              SearchNode const &node, int &value,
+                                              MoveList *const line) {
+        int const depth = node.depth;
+
+        // Static exchange pruning: past the search depth a capture that loses material
+        // isn't worth following, and near it off the principal variation neither is one
+        // that loses more than a pawn for each ply left
+        if (useSee && !node.inCheck && !board.isEmpty(board.getTargetSpot(move))) {
+            bool const prunable
+                = depth <= 0 || (depth <= SeePruneDepth && node.nullWindow && moveNumber > 1);
+            int const threshold = (depth <= 0) ? 0 : -pieceValues[Pawn] * depth;
+            if (prunable && board.see(move) < threshold) return MoveOutcome::Pruned;
+        }
+
+        MoveUndo const undo = board.executeMove(move);
+        board.nextTurn();
+
+        // after the first move a futile one is skipped unless it captures, promotes or
+        // gives check
+        if (node.futile && moveNumber > 1 && !move.isCapture() && !move.isPromotion()
+            && !board.kingIsInCheck(board.turn)) {
+            board.undoMove(move, undo);
+            return MoveOutcome::Pruned;
+        }
+
+        if (!hasMoves(*this, board, depth - 1)) {
+            board.undoMove(move, undo);
+            value = MAX_VALUE - (100 - depth);
+            if (line != nullptr) line->clear();
+            return MoveOutcome::Mate;
+        }
+
+        // The first move gets the full window.  The rest are expected to be worse so a
+        // null window only has to prove it, and one that isn't is searched again.
+        if (moveNumber == 1) {
+            value = -negamax(board, -beta, -alpha, depth - 1, line);
+        } else {
+            // Late move reductions: quiet moves this far down the ordering rarely turn
+            // out best so they are searched shallower first, and again at full depth
+            // only if they beat alpha.  Moves that give check are never reduced.
+            int reduction = 0;
+            if (useLateMoveReductions && !node.inCheck && depth >= 3 && !move.isCapture()
+                && !move.isPromotion() && !board.kingIsInCheck(board.turn)) {
+                reduction = min(lateMoveReduction(depth, moveNumber), depth - 2);
+            }
+
+            value = -negamax(board, -alpha - 1, -alpha, depth - 1 - reduction, line);
+            if (reduction > 0 && value > alpha) {
+                value = -negamax(board, -alpha - 1, -alpha, depth - 1, line);
+            }
+            if (value > alpha && value < beta) {
+                value = -negamax(board, -beta, -alpha, depth - 1, line);
+            }
+        }
+        board.undoMove(move, undo);
+        return MoveOutcome::Searched;
+    }
+
+    void Minimax::searchSplit(SplitPoint &split) {
+        Board board(split.board);
+        size_t const ply = board.history.size() - rootHistory;
+        SplitPoint const *const outer = currentSplit;
+        currentSplit = &split;
+
+        MoveList childLine;
+        MoveList *const childLinePtr = split.wantLine ? &childLine : nullptr;
+        unique_lock<mutex> guard(splitPool->lock);
+        while (split.next < split.moves.size() && !isStopped()) {
+            Move move = split.moves[split.next++];
+            int const alpha = split.alpha;
+            int const moveNumber = split.movesExamined + 1;
+            guard.unlock();
+
+            int value = 0;
+            MoveOutcome const outcome = negamaxMove(board, move, alpha, split.beta, moveNumber,
+                                                    split.node, value, childLinePtr);
+
+            guard.lock();
+            if (outcome == MoveOutcome::Pruned) {
+                split.pruned = true;
+                continue;
+            }
+
+            // a search cut short by a cutoff (here or further up) has nothing to add
+            if (isStopped()) break;
+            split.movesExamined++;
+
+            if (value > split.bestValue || outcome == MoveOutcome::Mate) {
+                split.bestValue = value;
+                split.bestMove = move;
+                if (split.wantLine) {
+                    split.line.clear();
+                    split.line.push_back(move);
+                    for (Move const &next : childLine) split.line.push_back(next);
+                }
+            }
+            if (value > split.alpha) split.alpha = value;
+            if (outcome == MoveOutcome::Mate || split.alpha >= split.beta) {
+                if (outcome != MoveOutcome::Mate) {
+                    heuristics.addCutoff(board.turn, move, ply, split.node.depth, moveNumber);
+                }
+                split.cutoff = true;
+            }
+        }
+        guard.unlock();
+        currentSplit = outer;
+    }
+
+    /**
+     * Captures-only quiescence search.  Scores are for the side to move as in negamax(...).
+     * Nothing is kept in the transposition table: the boards are too many and too short
+     * lived to be worth the slots.
+     *
+     */
+    int Minimax::quiesce(Board &origBoard, int alpha, int const beta, int const qply) {
+        int const sign = (origBoard.turn == White) ? 1 : -1;
+        Color const other = (origBoard.turn + 1) % 2;
+        bool const inCheck = origBoard.kingIsInCheck(origBoard.turn);
+
+        // Stand pat: the side to move doesn't have to capture anything so it scores at least
+        // what the board is worth now, unless it is in check and has to get out of it first.
+        // In check with no way out it is mated, later than any mate the full search finds.
+        int standPat = 0;
+        int best = MIN_VALUE + (100 + qply);
+        if (!inCheck) {
+            standPat = sign * Evaluator::evaluate(origBoard);
+            if (standPat >= beta) return standPat;
+            best = standPat;
+            alpha = max(alpha, standPat);
+        }
+
+        // In check every way out is searched.  Otherwise it is captures and promotions (to
+        // a spot on the last row), most valuable victim first, and then any quiet checks.
+        MoveList moves;
+        if (inCheck) {
+            moves = origBoard.getMoves1();
+        } else {
+            Bitboard const lastRow = (origBoard.turn == White) ? 0xFFull : 0xFFull << 56u;
+            moves = origBoard.getMoves(origBoard.turn, true,
+                                       origBoard.getOccupied(other) | lastRow);
+            auto const last = remove_if(moves.begin(), moves.end(), [&](Move const &move) {
+                return !move.isPromotion() && origBoard.isEmpty(origBoard.getTargetSpot(move));
+            });
+            moves.erase(last, moves.end());
+            for (Move &move : moves) {
+                int const promotion = move.isPromotion() ? move.getPromotion() * 8 : 0;
+                move.setValue(MovePicker::mvvLva(origBoard, move) + promotion);
+            }
+            stable_sort(moves.begin(), moves.end(), [](Move const &m1, Move const &m2) {
+                return m1.getValue() > m2.getValue();
+            });
+
+            if (quiescenceChecks && qply == 0) {
+                MoveList quiets
+                    = origBoard.getMoves(origBoard.turn, true, ~origBoard.getOccupied());
+                for (Move &move : quiets) {
+                    if (move.isPromotion()) continue;
+                    MoveUndo const undo = origBoard.executeMove(move);
+                    bool const check = origBoard.kingIsInCheck(other);
+                    origBoard.undoMove(move, undo);
+                    if (check) moves.push_back(move);
+                }
+            }
+        }
+
+        int movesExamined = 0;
+        for (Move &move : moves) {
+            yield();
+
+            // Delta pruning: a capture that couldn't reach alpha even if the piece came for
+            // free is no use, nor (with useSee) one that loses material
+            unsigned int const target = origBoard.getTargetSpot(move);
+            if (!inCheck && !move.isPromotion() && !origBoard.isEmpty(target)) {
+                int const gain = pieceValues[origBoard.getType(target)] / 100;
+                if (standPat + gain + DeltaMargin <= alpha) {
+                    continue;
+                }
+                if (useSee && origBoard.see(move) < 0) continue;
+            }
+
+            MoveUndo const undo = origBoard.executeMove(move);
+            origBoard.nextTurn();
+            movesExamined++;
+            int const value = -quiesce(origBoard, -beta, -alpha, qply + 1);
+            origBoard.undoMove(move, undo);
+
+            if (value > best) best = value;
+            if (value > alpha) alpha = value;
+            if (alpha >= beta) break;
+        }
+
+        if (movesExamined > 0) updateNumMoves(*this, movesExamined);
+        return best;
+    }
 
     ThreadResult::ThreadResult() { value = 0; }
 
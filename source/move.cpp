@@ -6,41 +6,47 @@
 
 namespace chess {
     using std::to_string;
-    Move::Move()
-        : captured(Empty), fromCol(0), fromRow(0), toCol(0), toRow(0), from(0), to(0), value(0) {}
+
+    PackedMove::PackedMove(unsigned int const from, unsigned int const to,
+                           unsigned int const flag, Piece const promotion)
+        : bits(static_cast<uint16_t>((from & 0x3Fu) | ((to & 0x3Fu) << 6u)
+                                     | (((promotion - Knight) & 0x3u) << 12u)
+                                     | ((flag & 0x3u) << 14u))) {}
+
+    Move::Move() : captured(Empty), value(0) {}
 
     Move::Move(unsigned int fromCol, unsigned int fromRow, unsigned int toCol, unsigned int toRow,
                int value)
-        : captured(Empty),
-          fromCol(fromCol),
-          fromRow(fromRow),
-          toCol(toCol),
-          toRow(toRow),
-          value(value) {
-        this->from = fromCol + fromRow * 8;
-        this->to = toCol + toRow * 8;
-    }
+        : packed(fromCol + fromRow * 8, toCol + toRow * 8), captured(Empty), value(value) {}
 
-    unsigned int Move::getFromCol() const { return fromCol; }
-    unsigned int Move::getFromRow() const { return fromRow; }
-    unsigned int Move::getToCol() const { return toCol; }
-    unsigned int Move::getToRow() const { return toRow; }
-    unsigned int Move::getFrom() const { return from; }
-    unsigned int Move::getTo() const { return to; }
+    Move::Move(PackedMove const packed, int const value)
+        : packed(packed), captured(Empty), value(value) {}
+
+    unsigned int Move::getFromCol() const { return packed.getFrom() % 8; }
+    unsigned int Move::getFromRow() const { return packed.getFrom() / 8; }
+    unsigned int Move::getToCol() const { return packed.getTo() % 8; }
+    unsigned int Move::getToRow() const { return packed.getTo() / 8; }
+    unsigned int Move::getFrom() const { return packed.getFrom(); }
+    unsigned int Move::getTo() const { return packed.getTo(); }
     int Move::getValue() const { return value; }
     Piece Move::getCaptured() const { return captured; }
     bool Move::isCapture() const { return captured != Empty; }
 
     void Move::setValue(int val) { value = val; }
-    void Move::setCaptured(Piece p) { captured = p; }
+    void Move::setCaptured(Piece p) { captured = static_cast<uint8_t>(p); }
+    void Move::setFlag(unsigned int const flag, Piece const promotion) {
+        packed = PackedMove(packed.getFrom(), packed.getTo(), flag, promotion);
+    }
 
     bool Move::operator==(Move const& move) const {
         if (this == &move) return true;
-        return from == move.from && to == move.to;
+        return getFrom() == move.getFrom() && getTo() == move.getTo();
     }
 
     string Move::to_string(unsigned int const flag) const {
         string result;
+        unsigned int const from = getFrom();
+        unsigned int const to = getTo();
         if (flag & 1u) result += getCoords(from) + " to " + getCoords(to) + " ";
         if (flag & 2u) result += getNotate(from) + " to " + getNotate(to);
         if (flag & 4u) result += " value:" + std::to_string(value);
@@ -48,10 +54,10 @@ namespace chess {
         return result;
     }
 
-    bool Move::isValid() const { return from != to; }
+    bool Move::isValid() const { return getFrom() != getTo(); }
 
     bool Move::isValid(Board const& board) const {
-        return (from != to) && (board.getType(from) != Empty);
+        return (getFrom() != getTo()) && (board.getType(getFrom()) != Empty);
     }
 
 }  // namespace chess
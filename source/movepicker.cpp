@@ -0,0 +1,149 @@
+//
+// movepicker.cpp
+//
+
+#include <movepicker.h>
+
+#include <algorithm>
+
+namespace chess {
+    using std::rotate;
+    using std::stable_sort;
+    using std::swap;
+
+    MovePicker::MovePicker(Board const &board, Move const &hashMove,
+                           SearchHeuristics const *heuristics, size_t ply, bool useSee)
+        : board(&board),
+          side(board.turn),
+          hashMove(hashMove),
+          stage(Stage::HashMove),
+          current(0),
+          heuristics(heuristics),
+          ply(ply),
+          useSee(useSee) {}
+
+    MovePicker::MovePicker(MoveList const &moves, Move const &hashMove,
+                           SearchHeuristics const *heuristics, Color side, size_t ply)
+        : board(nullptr),
+          side(side),
+          stage(Stage::Quiets),
+          moves(moves),
+          current(0),
+          heuristics(heuristics),
+          ply(ply),
+          useSee(false) {
+        if (heuristics != nullptr) {
+            size_t first = 0;
+            while (first < this->moves.size() && this->moves[first].getValue() > 0) first++;
+            orderQuiets(first);
+        }
+
+        if (!hashMove.isValid()) return;
+
+        // slide the moves ahead of the hash move down one to put it first
+        auto const found = find(this->moves.begin(), this->moves.end(), hashMove);
+        if (found != this->moves.end()) {
+            rotate(this->moves.begin(), found, found + 1);
+        }
+    }
+
+    void MovePicker::orderQuiets(size_t const first) {
+        if (heuristics == nullptr) return;
+
+        for (size_t ndx = first; ndx < moves.size(); ndx++) {
+            moves[ndx].setValue(heuristics->score(side, moves[ndx], ply));
+        }
+        stable_sort(moves.begin() + first, moves.end(), [](Move const &m1, Move const &m2) {
+            return m1.getValue() > m2.getValue();
+        });
+    }
+
+    int MovePicker::mvvLva(Board const &board, Move const &move) {
+        Piece const victim = board.getType(board.getTargetSpot(move));
+        Piece const attacker = board.getType(move.getFrom());
+        return int(victim * 8 + (King - attacker));
+    }
+
+    bool MovePicker::next(Move &move) {
+        switch (stage) {
+            case Stage::HashMove: {
+                stage = Stage::GenerateCaptures;
+
+                // Only use the hash move if one of our pieces can legally make it here.  The
+                // legal moves to its spot are worked out from the checkers and pins rather
+                // than by making it on a copy of the board.
+                unsigned int const from = hashMove.getFrom();
+                if (hashMove.isValid() && !board->isEmpty(from) && board->getSide(from) == side) {
+                    MoveList const legal
+                        = board->getMoves(side, true, spotBit(board->getTargetSpot(hashMove)));
+                    auto const found = find(legal.begin(), legal.end(), hashMove);
+                    if (found != legal.end()) {
+                        move = hashMove = *found;
+                        return true;
+                    }
+                }
+                hashMove = Move();
+            }
+                [[fallthrough]];
+
+            case Stage::GenerateCaptures:
+                moves = board->getMoves(side, true, board->getOccupied((side + 1) % 2));
+                for (Move &capture : moves) {
+                    capture.setValue(mvvLva(*board, capture));
+                }
+                current = 0;
+                stage = Stage::Captures;
+                [[fallthrough]];
+
+            case Stage::Captures:
+                while (current < moves.size()) {
+                    // select the best of the captures left rather than sorting them all
+                    size_t best = current;
+                    for (size_t ndx = current + 1; ndx < moves.size(); ++ndx) {
+                        if (moves[ndx].getValue() > moves[best].getValue()) best = ndx;
+                    }
+                    swap(moves[current], moves[best]);
+                    move = moves[current++];
+                    if (move == hashMove) continue;
+                    if (useSee && board->see(move) < 0) {
+                        badCaptures.push_back(move);
+                        continue;
+                    }
+                    return true;
+                }
+                stage = Stage::GenerateQuiets;
+                [[fallthrough]];
+
+            case Stage::GenerateQuiets:
+                // en passant captures count as moves to the spot of the pawn they capture
+                // so they came out with the other captures and are left out here
+                moves = board->getMoves(side, true, ~board->getOccupied());
+                orderQuiets(0);
+                current = 0;
+                stage = Stage::Quiets;
+                [[fallthrough]];
+
+            case Stage::Quiets:
+                while (current < moves.size()) {
+                    move = moves[current++];
+                    if (board == nullptr || !(move == hashMove)) return true;
+                }
+                current = 0;
+                stage = Stage::BadCaptures;
+                [[fallthrough]];
+
+            case Stage::BadCaptures:
+                if (current < badCaptures.size()) {
+                    move = badCaptures[current++];
+                    return true;
+                }
+                stage = Stage::Done;
+                [[fallthrough]];
+
+            case Stage::Done:
+                break;
+        }
+        return false;
+    }
+
+}  // namespace chess
@@ -0,0 +1,119 @@
+//
+// threadpool.cpp
+//
+
+#include <threadpool.h>
+
+#include <algorithm>
+
+namespace chess {
+    using std::lock_guard;
+    using std::memory_order_acquire;
+    using std::memory_order_release;
+    using std::min;
+    using std::unique_lock;
+
+    // std::min(...) takes it by reference so it needs a definition as well
+    unsigned const ThreadPool::MaxThreads;
+
+    // the pool and queue of the worker running on each thread (nullptr off the workers)
+    static thread_local ThreadPool const *workerPool = nullptr;
+    static thread_local unsigned workerIndex = 0;
+
+    ThreadPool::ThreadPool(unsigned const count) : workers(new Worker[MaxThreads]) {
+        reserve(count);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stop = true;
+        }
+        available.notify_all();
+        for (thread &worker : threads) worker.join();
+    }
+
+    ThreadPool &ThreadPool::shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    unsigned ThreadPool::threadSlot() { return (workerPool != nullptr) ? workerIndex + 1 : 0; }
+
+    void ThreadPool::reserve(unsigned const count) {
+        lock_guard<mutex> guard(lock);
+        unsigned const wanted = min(count, MaxThreads);
+        while (threads.size() < wanted) {
+            unsigned const self = unsigned(threads.size());
+            threads.emplace_back(&ThreadPool::run, this, self);
+            numWorkers.store(self + 1, memory_order_release);
+        }
+    }
+
+    void ThreadPool::push(function<void()> task) {
+        unsigned const count = numWorkers.load(memory_order_acquire);
+        if (count == 0) {
+            task();
+            return;
+        }
+
+        unsigned const queue = (workerPool == this) ? workerIndex : nextWorker++ % count;
+        {
+            lock_guard<mutex> guard(workers[queue].lock);
+            workers[queue].tasks.push_back(std::move(task));
+        }
+        {
+            // counted under the lock so a worker about to wait can't miss it
+            lock_guard<mutex> guard(lock);
+            pending++;
+        }
+        available.notify_one();
+    }
+
+    bool ThreadPool::take(unsigned const self, function<void()> &task) {
+        {
+            Worker &own = workers[self];
+            lock_guard<mutex> guard(own.lock);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending--;
+                return true;
+            }
+        }
+
+        unsigned const count = numWorkers.load(memory_order_acquire);
+        for (unsigned offset = 1; offset < count; offset++) {
+            Worker &victim = workers[(self + offset) % count];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                pending--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::run(unsigned const self) {
+        workerPool = this;
+        workerIndex = self;
+
+        function<void()> task;
+        while (true) {
+            if (take(self, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            unique_lock<mutex> guard(lock);
+            available.wait(guard, [this]() { return stop || pending > 0; });
+            if (stop && pending <= 0) break;
+        }
+
+        workerPool = nullptr;
+    }
+
+}  // namespace chess
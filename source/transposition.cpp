@@ -0,0 +1,187 @@
+/**
+ * The TranspositionTable class keeps the results of searching board positions, keyed by their
+ * Zobrist hash
+ *
+ */
+
+#include <transposition.h>
+#include <stdio.h>  // for snprintf(...)
+
+#include <algorithm>
+
+namespace chess {
+    using std::max;
+    using std::memory_order_relaxed;
+    using std::min;
+
+    TranspositionTable::TranspositionTable(size_t const megabytes) { resize(megabytes); }
+
+    TranspositionTable::TranspositionTable(TranspositionTable const &ref) { *this = ref; }
+
+    TranspositionTable &TranspositionTable::operator=(TranspositionTable const &ref) {
+        if (this == &ref) return *this;
+
+        buckets.reset((ref.numBuckets > 0) ? new Bucket[ref.numBuckets] : nullptr);
+        numBuckets = ref.numBuckets;
+        age = ref.age;
+        for (size_t ndx = 0; ndx < numBuckets; ndx++) {
+            for (unsigned int slot = 0; slot < BucketSize; slot++) {
+                Slot const &from = ref.buckets[ndx].slots[slot];
+                Slot &to = buckets[ndx].slots[slot];
+                to.check.store(from.check.load(memory_order_relaxed), memory_order_relaxed);
+                to.data.store(from.data.load(memory_order_relaxed), memory_order_relaxed);
+            }
+        }
+        for (Counts &count : counts) {
+            count.probes.store(0, memory_order_relaxed);
+            count.hits.store(0, memory_order_relaxed);
+            count.stores.store(0, memory_order_relaxed);
+        }
+        counts[0].probes.store(ref.countProbes(), memory_order_relaxed);
+        counts[0].hits.store(ref.countHits(), memory_order_relaxed);
+        counts[0].stores.store(ref.countStores(), memory_order_relaxed);
+        return *this;
+    }
+
+    void TranspositionTable::resize(size_t const megabytes) {
+        size_t const bytes = megabytes * 1024 * 1024;
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= bytes) {
+            count *= 2;
+        }
+
+        buckets = unique_ptr<Bucket[]>(new Bucket[count]);
+        numBuckets = count;
+        clear();
+    }
+
+    void TranspositionTable::clear() {
+        for (size_t ndx = 0; ndx < numBuckets; ndx++) {
+            for (Slot &slot : buckets[ndx].slots) {
+                slot.check.store(0, memory_order_relaxed);
+                slot.data.store(0, memory_order_relaxed);
+            }
+        }
+        age = 0;
+        for (Counts &count : counts) {
+            count.probes.store(0, memory_order_relaxed);
+            count.hits.store(0, memory_order_relaxed);
+            count.stores.store(0, memory_order_relaxed);
+        }
+    }
+
+    long TranspositionTable::total(atomic<long> Counts::*const count) const {
+        long sum = 0;
+        for (Counts const &slot : counts) sum += (slot.*count).load(memory_order_relaxed);
+        return sum;
+    }
+
+    uint64_t TranspositionTable::pack(TTEntry const &entry) {
+        return uint64_t(uint32_t(entry.score)) | (uint64_t(entry.move.getBits()) << 32u)
+               | (uint64_t(uint8_t(int8_t(entry.depth))) << 48u)
+               | (uint64_t(entry.bound & 0x3u) << 56u) | (uint64_t(entry.age & 0x3Fu) << 58u);
+    }
+
+    TTEntry TranspositionTable::unpack(uint64_t const data) {
+        TTEntry entry;
+        entry.score = int32_t(uint32_t(data & 0xFFFFFFFFull));
+        entry.move = PackedMove(uint16_t(data >> 32u));
+        entry.depth = int8_t(uint8_t(data >> 48u));
+        entry.bound = unsigned((data >> 56u) & 0x3u);
+        entry.age = unsigned((data >> 58u) & 0x3Fu);
+        return entry;
+    }
+
+    TTEntry TranspositionTable::probe(HashKey const key) const {
+        if (numBuckets == 0) return TTEntry();
+
+        // only this thread writes its own counts so the adds never wait on another thread
+        Counts &own = ownCounts();
+        own.probes.fetch_add(1, memory_order_relaxed);
+        for (Slot const &slot : bucketFor(key).slots) {
+            uint64_t const data = slot.data.load(memory_order_relaxed);
+            if ((slot.check.load(memory_order_relaxed) ^ data) != key) continue;
+
+            TTEntry const entry = unpack(data);
+            if (entry.isValid()) {
+                own.hits.fetch_add(1, memory_order_relaxed);
+                return entry;
+            }
+        }
+        return TTEntry();
+    }
+
+    void TranspositionTable::store(HashKey const key, Move const &move, int const score,
+                                   int const depth, unsigned int const bound) {
+        if (numBuckets == 0) return;
+
+        Bucket &bucket = bucketFor(key);
+        Slot *replace = nullptr;
+        int worst = 0;
+        for (Slot &slot : bucket.slots) {
+            uint64_t const data = slot.data.load(memory_order_relaxed);
+            TTEntry const entry = unpack(data);
+
+            if (entry.isValid() && (slot.check.load(memory_order_relaxed) ^ data) == key) {
+                // the same position: keep a deeper result from this search over an inexact one
+                if (entry.age == age && entry.depth > depth && bound != TTEntry::Exact) return;
+                replace = &slot;
+                break;
+            }
+
+            // prefer empty slots, then older searches, then shallower depths
+            int const ageDiff = int((age - entry.age) & 0x3Fu);
+            int const keep = entry.isValid() ? entry.depth - ageDiff * 8 : -1'000;
+            if (replace == nullptr || keep < worst) {
+                replace = &slot;
+                worst = keep;
+            }
+        }
+
+        TTEntry entry;
+        entry.move = move.isValid() ? move.getPacked() : PackedMove();
+        entry.score = score;
+        entry.depth = max(-128, min(127, depth));
+        entry.bound = bound;
+        entry.age = age;
+
+        uint64_t const data = pack(entry);
+        replace->check.store(key ^ data, memory_order_relaxed);
+        replace->data.store(data, memory_order_relaxed);
+        ownCounts().stores.fetch_add(1, memory_order_relaxed);
+    }
+
+    int TranspositionTable::hashFull() const {
+        size_t const sample = min(numBuckets, size_t(1000 / BucketSize));
+        if (sample == 0) return 0;
+
+        int used = 0;
+        for (size_t ndx = 0; ndx < sample; ndx++) {
+            for (Slot const &slot : buckets[ndx].slots) {
+                TTEntry const entry = unpack(slot.data.load(memory_order_relaxed));
+                if (entry.isValid() && entry.age == age) used++;
+            }
+        }
+        return int(used * 1000 / (sample * BucketSize));
+    }
+
+    void TranspositionTable::showMetrics() const {
+        using std::cout, std::endl;
+        char buff[256] = "0.00 %";
+        long const probes = countProbes();
+        long const hits = countHits();
+        if (probes > 0) {
+            double pctFound = (double(hits) / double(probes)) * 100.0;
+            snprintf(buff, sizeof(buff), "%-.4g %%", pctFound);
+        }
+
+        cout << "Entries : " << addCommas(long(size())) << endl;
+        cout << "Probes  : " << addCommas(probes) << endl;
+        cout << "Found   : " << addCommas(hits) << endl;
+        cout << "Used    : " << buff << endl;
+        cout << "Stores  : " << addCommas(countStores()) << endl;
+        int const full = hashFull();
+        cout << "Full    : " << full / 10 << "." << full % 10 << " %" << endl;
+    }
+
+}  // namespace chess
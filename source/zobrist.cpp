@@ -0,0 +1,67 @@
+//
+// zobrist.cpp
+//
+// the Zobrist key tables, filled once from a fixed seed so hashes are the same every run
+//
+
+#include <zobrist.h>
+
+#include <array>
+
+namespace chess {
+    using std::array;
+
+    namespace {
+        struct ZobristKeys {
+            array<array<array<HashKey, BOARD_SIZE>, 8>, 2> piece{};
+            array<HashKey, 16> castle{};
+            array<HashKey, NoEnPassant + 1> enPassant{};
+            HashKey side{};
+
+            ZobristKeys() {
+                HashKey state = 0x9E3779B97F4A7C15ull;
+                for (auto &types : piece) {
+                    // no keys for Empty so xor'ing an empty spot in or out changes nothing
+                    for (Piece type = Pawn; type <= King; type++) {
+                        for (HashKey &key : types[type]) key = next(state);
+                    }
+                }
+
+                // no rights and no en passant have no key either
+                for (unsigned int rights = 1; rights < castle.size(); rights++) {
+                    castle[rights] = next(state);
+                }
+                for (unsigned int col = 0; col < NoEnPassant; col++) {
+                    enPassant[col] = next(state);
+                }
+                side = next(state);
+            }
+
+            /// splitmix64: a small generator with well mixed output for any seed
+            static HashKey next(HashKey &state) {
+                HashKey z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31u);
+            }
+        };
+
+        ZobristKeys const &zobristKeys() {
+            static ZobristKeys const keys;
+            return keys;
+        }
+    }  // namespace
+
+    HashKey pieceKey(Piece const piece, unsigned int const ndx) {
+        return zobristKeys().piece[getSide(piece)][getType(piece)][ndx];
+    }
+
+    HashKey castleKey(unsigned int const rights) { return zobristKeys().castle[rights & 0xFu]; }
+
+    HashKey enPassantKey(unsigned int const col) {
+        return zobristKeys().enPassant[col <= NoEnPassant ? col : NoEnPassant];
+    }
+
+    HashKey sideKey() { return zobristKeys().side; }
+
+}  // namespace chess
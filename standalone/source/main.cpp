@@ -46,18 +46,59 @@ int main(int argc, char **argv) {
     agent1.maxDepth = options.getInt("ply", 1);
     agent1.useCache = options.getBool("cache", false);
     agent1.useThreads = options.getBool("threads", true);
+    agent1.useSharedWindow = options.getBool("sharedwindow", false);
+    agent1.useLazySmp = options.getBool("lazysmp", false);
+    agent1.useYbwc = options.getBool("ybwc", false);
+    agent1.numThreads = options.getInt("numthreads", 0);
+    agent1.useMovePicker = options.getBool("picker", false);
+    agent1.useIterativeDeepening = options.getBool("deepen", false);
+    agent1.useNegamax = options.getBool("pvs", false);
+    agent1.useAspiration = options.getBool("aspiration", false);
+    agent1.aspirationWindow = options.getInt("window", 75);
+    agent1.useNullMove = options.getBool("nullmove", false);
+    agent1.nullMoveReduction = options.getInt("nullr", 2);
+    agent1.useLateMoveReductions = options.getBool("lmr", false);
+    agent1.useKillers = options.getBool("killers", false);
+    agent1.useSee = options.getBool("see", false);
+    agent1.useQuiescence = options.getBool("quiesce", false);
+    agent1.quiescenceChecks = options.getBool("qchecks", false);
+    agent1.useFutility = options.getBool("futility", false);
+    agent1.futilityMargin = options.getInt("fmargin", 150);
+    agent1.reverseFutilityMargin = options.getInt("rfmargin", 120);
+    agent1.razorMargin = options.getInt("razor", 300);
     agent1.extraChecks = options.getBool("extra", false);
-    agent1.acceptableRiskLevel = options.getFloat("risk", 0.25);
+    agent1.cacheSize = options.getInt("cachesize", 16);
     agent1.reserve = options.getInt("reserve", 0);
     agent1.qMaxDepth = 0 - options.getInt("qmax", 2);
     agent1.timeout = options.getInt("timeout", 10);
     board.maxRep = options.getInt("maxrep", 3);
 
     cout << "use threads       :  " << agent1.useThreads << endl;
+    cout << "shared window     :  " << agent1.useSharedWindow << endl;
+    cout << "lazy smp          :  " << agent1.useLazySmp << endl;
+    cout << "ybwc              :  " << agent1.useYbwc << endl;
+    cout << "search threads    :  " << agent1.numThreads << endl;
     cout << "use cache         :  " << agent1.useCache << endl;
+    cout << "use move picker   :  " << agent1.useMovePicker << endl;
+    cout << "iterative deepen  :  " << agent1.useIterativeDeepening << endl;
+    cout << "negamax pvs       :  " << agent1.useNegamax << endl;
+    cout << "aspiration window :  " << (agent1.useAspiration ? agent1.aspirationWindow : 0) << endl;
+    cout << "null move R       :  " << (agent1.useNullMove ? agent1.nullMoveReduction : 0) << endl;
+    cout << "late move reduce  :  " << agent1.useLateMoveReductions << endl;
+    cout << "killers/history   :  " << agent1.useKillers << endl;
+    cout << "static exchange   :  " << agent1.useSee << endl;
+    cout << "quiescence        :  " << agent1.useQuiescence << endl;
+    cout << "quiescent checks  :  " << agent1.quiescenceChecks << endl;
+    cout << "futility margins  :  ";
+    if (agent1.useFutility) {
+        cout << agent1.futilityMargin << " / " << agent1.reverseFutilityMargin << " / "
+             << agent1.razorMargin << endl;
+    } else {
+        cout << 0 << endl;
+    }
     cout << "max ply depth     :  " << agent1.maxDepth << endl;
     cout << "timeout           :  " << agent1.timeout << endl;
-    cout << "risk level        :  " << agent1.acceptableRiskLevel << endl;
+    cout << "cache size (MB)   :  " << agent1.cacheSize << endl;
     cout << "max repetitions   :  " << board.maxRep << endl;
     cout << "extra checks      :  " << agent1.extraChecks << endl;
     cout << "reserve           :  " << agent1.reserve << endl;
@@ -72,8 +113,18 @@ int main(int argc, char **argv) {
 }
 
 static void showGameEndSummary() {
-    if (getAgent().useCache) {
-        getAgent().cache.showMetrics();
+    Minimax const &agent = getAgent();
+    if (agent.useCache) {
+        agent.cache.showMetrics();
+    }
+    if (agent.cutoffs > 0) {
+        double const firstPct = double(agent.firstMoveCutoffs) * 100.0 / double(agent.cutoffs);
+        cout << "Cutoffs   : " << addCommas(agent.cutoffs) << endl;
+        cout << "1st Move  : " << std::to_string(int(firstPct + 0.5)) << " %" << endl;
+    }
+    if (agent.useAspiration) {
+        cout << "Fail High : " << addCommas(agent.failHighs) << endl;
+        cout << "Fail Low  : " << addCommas(agent.failLows) << endl;
     }
     cout << endl;
 }
@@ -167,7 +218,7 @@ static void playGame(Board &board, Minimax &agent1, Minimax &agent2) {
 
     if (board.checkDrawByRepetition(move)) {
         cout << "Draw by repetition!" << endl;
-    } else if (board.moves1.empty() && board.moves2.empty()) {
+    } else if (board.getMoves1().empty() && board.getMoves2().empty()) {
         cout << "Stalemate!" << endl;
     } else if (board.kingIsInCheck(White) || board.kingIsInCheck(Black)) {
         cout << "Checkmate!" << endl;
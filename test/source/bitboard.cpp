@@ -0,0 +1,119 @@
+#include <doctest/doctest.h>
+
+#if defined(_WIN32) || defined(WIN32)
+// apparently this is required to compile in MSVC++
+#    include <sstream>
+#endif
+
+#include <bitboard.h>
+#include <board.h>
+
+namespace chess {
+    /**
+     * check that the bitboards agree with the board array spot for spot
+     *
+     */
+    static bool bitboardsMatch(Board const &game) {
+        Board synced(game);
+        synced.updateBitboards();
+        return synced.pieceBits == game.pieceBits && synced.sideBits == game.sideBits;
+    }
+
+    /**
+     * unit tests for Bitboard primitives and the Board bitboards
+     *
+     */
+    TEST_CASE("chess::Bitboard") {
+        CHECK(spotBit(0) == 1ull);
+        CHECK(spotBit(63) == 0x80000000'00000000ull);
+        CHECK(popCount(NoSpots) == 0);
+        CHECK(popCount(AllSpots) == 64);
+        CHECK(popCount(spotBit(3) | spotBit(42)) == 2);
+        CHECK(lsb(spotBit(42) | spotBit(63)) == 42);
+
+        Bitboard bits = spotBit(5) | spotBit(17);
+        CHECK(popLsb(bits) == 5);
+        CHECK(popLsb(bits) == 17);
+        CHECK(bits == NoSpots);
+
+        // slider attacks on an empty board
+        CHECK(popCount(rookAttacks(0, NoSpots)) == 14);
+        CHECK(popCount(bishopAttacks(0, NoSpots)) == 7);
+        CHECK(popCount(bishopAttacks(4 + 4 * 8, NoSpots)) == 13);
+        CHECK(popCount(queenAttacks(4 + 4 * 8, NoSpots)) == 27);
+
+        // slider attacks stop at (and include) the first occupied spot along each ray
+        Bitboard const blockers = spotBit(4 + 1 * 8) | spotBit(6 + 4 * 8) | spotBit(2 + 2 * 8);
+        Bitboard const rook = rookAttacks(4 + 4 * 8, blockers);
+        CHECK(popCount(rook) == 12);
+        CHECK((rook & spotBit(4 + 1 * 8)) != NoSpots);
+        CHECK((rook & spotBit(4 + 0 * 8)) == NoSpots);
+        CHECK((rook & spotBit(6 + 4 * 8)) != NoSpots);
+        CHECK((rook & spotBit(7 + 4 * 8)) == NoSpots);
+        Bitboard const bishop = bishopAttacks(4 + 4 * 8, blockers);
+        CHECK(popCount(bishop) == 11);
+        CHECK((bishop & spotBit(2 + 2 * 8)) != NoSpots);
+        CHECK((bishop & spotBit(1 + 1 * 8)) == NoSpots);
+
+        // knight, king and pawn attacks
+        CHECK(popCount(knightAttacks(0)) == 2);
+        CHECK(popCount(knightAttacks(4 + 4 * 8)) == 8);
+        CHECK(popCount(kingAttacks(0)) == 3);
+        CHECK(popCount(kingAttacks(4 + 4 * 8)) == 8);
+        CHECK(pawnAttacks(White, 4 + 6 * 8) == (spotBit(3 + 5 * 8) | spotBit(5 + 5 * 8)));
+        CHECK(pawnAttacks(Black, 4 + 1 * 8) == (spotBit(3 + 2 * 8) | spotBit(5 + 2 * 8)));
+        CHECK(pawnAttacks(White, 0 + 6 * 8) == spotBit(1 + 5 * 8));
+
+        // new game
+        Board game;
+        CHECK(game.getOccupied(Black) == 0x00000000'0000FFFFull);
+        CHECK(game.getOccupied(White) == 0xFFFF0000'00000000ull);
+        CHECK(game.getPieces(Pawn) == 0x00FF0000'0000FF00ull);
+        CHECK(game.getPieces(White, King) == spotBit(4 + 7 * 8));
+        CHECK(game.getPieces(Black, Queen) == spotBit(3 + 0 * 8));
+        CHECK(popCount(game.getOccupied()) == 32);
+        CHECK(bitboardsMatch(game));
+
+        // quiet move and capture
+        Move move(4, 6, 4, 4, 0);
+        game.executeMove(move);
+        move = Move(3, 1, 3, 3, 0);
+        game.executeMove(move);
+        move = Move(4, 4, 3, 3, 0);
+        game.executeMove(move);
+        CHECK(move.isCapture());
+        CHECK(game.getPieces(Black, Pawn) == (0x00000000'0000FF00ull & ~spotBit(3 + 1 * 8)));
+        CHECK(popCount(game.getOccupied()) == 31);
+        CHECK(bitboardsMatch(game));
+
+        // setters keep the bitboards up to date
+        game.setType(3 + 3 * 8, Knight);
+        CHECK((game.getPieces(White, Knight) & spotBit(3 + 3 * 8)) != NoSpots);
+        game.setSide(3 + 3 * 8, Black);
+        CHECK((game.getPieces(Black, Knight) & spotBit(3 + 3 * 8)) != NoSpots);
+        game.setSpot(3 + 3 * 8, Empty);
+        CHECK((game.getOccupied() & spotBit(3 + 3 * 8)) == NoSpots);
+        CHECK(bitboardsMatch(game));
+
+        // castling moves the rook too
+        game = Board();
+        game.setSpot(5 + 7 * 8, Empty);
+        game.setSpot(6 + 7 * 8, Empty);
+        move = Move(4, 7, 6, 7, 0);
+        game.executeMove(move);
+        CHECK(game.getPieces(White, King) == spotBit(6 + 7 * 8));
+        CHECK((game.getPieces(White, Rook) & spotBit(5 + 7 * 8)) != NoSpots);
+        CHECK((game.getOccupied() & spotBit(7 + 7 * 8)) == NoSpots);
+        CHECK(bitboardsMatch(game));
+
+        // promotion
+        game.board.fill(Empty);
+        game.board[4 + 1 * 8] = makeSpot(Pawn, White);
+        game.updateBitboards();
+        move = Move(4, 1, 4, 0, 0);
+        game.executeMove(move);
+        CHECK(game.getPieces(Pawn) == NoSpots);
+        CHECK(game.getPieces(White, Queen) == spotBit(4 + 0 * 8));
+        CHECK(bitboardsMatch(game));
+    }
+}  // namespace chess
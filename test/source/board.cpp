@@ -546,4 +546,403 @@ namespace chess {
         // Test that if we tried the first move once more it would be caught:
         CHECK(game.checkDrawByRepetition(move1));
     }
+
+    /**
+     * check that taking back a move restores the board state exactly
+     *
+     */
+    static void checkUndo(Board &game, Move move) {
+        Board const before(game);
+        MoveUndo const undo = game.executeMove(move);
+        game.advanceTurn();
+        game.undoMove(move, undo);
+
+        CHECK(game.board == before.board);
+        CHECK(game.pieceBits == before.pieceBits);
+        CHECK(game.sideBits == before.sideBits);
+        CHECK(game.ndxKing1 == before.ndxKing1);
+        CHECK(game.ndxKing2 == before.ndxKing2);
+        CHECK(game.taken1 == before.taken1);
+        CHECK(game.taken2 == before.taken2);
+        CHECK(game.history.size() == before.history.size());
+        CHECK(game.turn == before.turn);
+        CHECK(game.turns == before.turns);
+    }
+
+    /**
+     * unit tests for taking moves back
+     *
+     */
+    TEST_CASE("chess::Board::undoMove") {
+        Board game;
+
+        // quiet moves for every starting move of both sides
+        for (Move const &move : game.moves1) checkUndo(game, move);
+        for (Move const &move : game.moves2) checkUndo(game, move);
+
+        // normal capture
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White);
+        game.board[4 + 0 * 8] = makeSpot(King, Black);
+        game.board[3 + 4 * 8] = makeSpot(Pawn, White, true);
+        game.board[4 + 3 * 8] = makeSpot(Knight, Black, true);
+        game.generateMoveLists();
+        checkUndo(game, Move(3, 4, 4, 3, 0));
+
+        // en passant capture
+        game.board[4 + 3 * 8] = Empty;
+        game.board[3 + 3 * 8] = makeSpot(Pawn, White, true);
+        game.board[4 + 3 * 8] = makeSpot(Pawn, Black, true);
+        game.history.emplace_back(Move(4, 1, 4, 3, 0));
+        game.generateMoveLists();
+        checkUndo(game, Move(3, 3, 4, 2, 0));
+
+        // promotion with and without a capture
+        game.board[1 + 1 * 8] = makeSpot(Pawn, White, true);
+        game.board[2 + 0 * 8] = makeSpot(Rook, Black, true);
+        game.generateMoveLists();
+        checkUndo(game, Move(1, 1, 1, 0, 0));
+        checkUndo(game, Move(1, 1, 2, 0, 0));
+
+        // castling on both sides and a king move
+        game.board[0 + 7 * 8] = makeSpot(Rook, White);
+        game.board[7 + 7 * 8] = makeSpot(Rook, White);
+        game.generateMoveLists();
+        checkUndo(game, Move(4, 7, 6, 7, 0));
+        checkUndo(game, Move(4, 7, 2, 7, 0));
+        checkUndo(game, Move(4, 7, 4, 6, 0));
+        CHECK(game.ndxKing1 == 4 + 7 * 8);
+        CHECK(!game.hasMoved(4 + 7 * 8));
+        CHECK(!game.hasMoved(7 + 7 * 8));
+    }
+
+    /**
+     * unit tests for advancing the turn without generating the move lists
+     *
+     */
+    TEST_CASE("chess::Board::nextTurn") {
+        Board eager;
+        Board lazy;
+        Move move(4, 6, 4, 4, 0);
+        eager.executeMove(move);
+        eager.advanceTurn();
+        lazy.executeMove(move);
+        lazy.nextTurn();
+
+        CHECK(lazy.turn == eager.turn);
+        CHECK(lazy.turns == eager.turns);
+        CHECK(!lazy.moves1Ready);
+        CHECK(!lazy.moves2Ready);
+
+        // each list is generated on first use, the other is left alone
+        CHECK(lazy.getMoves1().size() == eager.moves1.size());
+        CHECK(lazy.moves1Ready);
+        CHECK(!lazy.moves2Ready);
+        CHECK(lazy.getMoves2().size() == eager.moves2.size());
+        CHECK(lazy.moves2Ready);
+        for (size_t i = 0; i < eager.moves1.size(); i++) {
+            CHECK(lazy.getMoves1()[i] == eager.moves1[i]);
+        }
+
+        // making or taking back a move leaves the lists to be generated again
+        MoveUndo const undo = lazy.executeMove(move = Move(3, 1, 3, 3, 0));
+        CHECK(!lazy.moves1Ready);
+        lazy.nextTurn();
+        CHECK(lazy.getMoves1().size() == 31);
+        lazy.undoMove(move, undo);
+        CHECK(!lazy.moves1Ready);
+        CHECK(lazy.getMoves1().size() == eager.moves1.size());
+    }
+
+    /**
+     * unit tests for the Zobrist hash
+     *
+     */
+    TEST_CASE("chess::Board::getHash") {
+        Board game;
+        HashKey const start = game.getHash();
+        CHECK(game.hash == game.computeHash());
+        CHECK(game.getCastleRights()
+              == (WhiteKingSide | WhiteQueenSide | BlackKingSide | BlackQueenSide));
+        CHECK(game.getEnPassantCol() == NoEnPassant);
+
+        // the side to move is part of the hash
+        game.turn = Black;
+        CHECK(game.getHash() != start);
+        game.turn = White;
+        CHECK(game.getHash() == start);
+
+        // knights out and back again repeat the starting position
+        for (Move move : {Move(6, 7, 5, 5, 0), Move(6, 0, 5, 2, 0), Move(5, 5, 6, 7, 0),
+                          Move(5, 2, 6, 0, 0)}) {
+            CHECK(game.countRepetitions() == 0);
+            game.executeMove(move);
+            game.nextTurn();
+        }
+        CHECK(game.getHash() == start);
+        CHECK(game.hash == game.computeHash());
+        CHECK(game.countRepetitions() == 1);
+
+        // a double pawn push allows en passant on its column
+        Move move(4, 6, 4, 4, 0);
+        MoveUndo const undo = game.executeMove(move);
+        CHECK(game.getEnPassantCol() == 4);
+        CHECK(game.hash == game.computeHash());
+        game.undoMove(move, undo);
+        CHECK(game.getHash() == start);
+
+        // moving a king or rook gives up castling
+        game.setMoved(7 + 7 * 8, true);
+        CHECK(game.getCastleRights() == (WhiteQueenSide | BlackKingSide | BlackQueenSide));
+        CHECK(game.hash == game.computeHash());
+        game.setMoved(7 + 7 * 8, false);
+        CHECK(game.getHash() == start);
+        game.setSpot(4 + 0 * 8, Empty);
+        CHECK(game.getCastleRights() == (WhiteKingSide | WhiteQueenSide));
+        CHECK(game.hash == game.computeHash());
+    }
+
+    /**
+     * unit tests for spot attack queries
+     *
+     */
+    TEST_CASE("chess::Board::executeNullMove") {
+        Board game;
+        Move push(4, 6, 4, 4, 0);
+        game.executeMove(push);
+        game.nextTurn();
+        HashKey const before = game.getHash();
+        CHECK(game.getEnPassantCol() == 4);
+
+        // passing gives the turn away and loses en passant
+        MoveUndo const undo = game.executeNullMove();
+        game.nextTurn();
+        CHECK(game.turn == White);
+        CHECK(game.getEnPassantCol() == NoEnPassant);
+        CHECK(!game.lastMove().isValid());
+        CHECK(game.getHash() != before);
+        CHECK(game.hash == game.computeHash());
+        CHECK(game.getMoves1().size() == 30);
+
+        game.undoNullMove(undo);
+        CHECK(game.turn == Black);
+        CHECK(game.getEnPassantCol() == 4);
+        CHECK(game.getHash() == before);
+        CHECK(game.history.size() == 1);
+        CHECK(game.hashHistory.size() == 1);
+
+        CHECK(popCount(game.getNonPawnPieces(White)) == 7);
+        game.setSpot(3 + 7 * 8, Empty);
+        CHECK(popCount(game.getNonPawnPieces(White)) == 6);
+    }
+
+    TEST_CASE("chess::Board::see") {
+        Board game;
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White);
+        game.board[4 + 0 * 8] = makeSpot(King, Black);
+        int const pawn = pieceValues[Pawn];
+        int const knight = pieceValues[Knight];
+        int const rook = pieceValues[Rook];
+        int const queen = pieceValues[Queen];
+
+        // an undefended pawn is won outright
+        game.board[3 + 3 * 8] = makeSpot(Pawn, Black, true);
+        game.board[3 + 6 * 8] = makeSpot(Queen, White, true);
+        game.updateBitboards();
+        CHECK(game.see(Move(3, 6, 3, 3, 0)) == pawn);
+
+        // defended by a pawn the queen is lost for it
+        game.board[2 + 2 * 8] = makeSpot(Pawn, Black, true);
+        game.updateBitboards();
+        CHECK(game.see(Move(3, 6, 3, 3, 0)) == pawn - queen);
+
+        // but a pawn taking a defended knight wins it, and the queen wins the pawn back
+        game.board[3 + 3 * 8] = makeSpot(Knight, Black, true);
+        game.board[4 + 4 * 8] = makeSpot(Pawn, White, true);
+        game.updateBitboards();
+        CHECK(game.see(Move(4, 4, 3, 3, 0)) == knight);
+        game.board[3 + 6 * 8] = Empty;
+        game.updateBitboards();
+        CHECK(game.see(Move(4, 4, 3, 3, 0)) == knight - pawn);
+        CHECK(game.see(Move(4, 4, 4, 3, 0)) == 0);
+
+        // a rook behind the first rook (an x-ray) joins in once the first one has gone
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White);
+        game.board[7 + 0 * 8] = makeSpot(King, Black);
+        game.board[3 + 2 * 8] = makeSpot(Rook, Black, true);
+        game.board[2 + 1 * 8] = makeSpot(Pawn, Black, true);
+        game.board[3 + 5 * 8] = makeSpot(Rook, White, true);
+        game.board[3 + 6 * 8] = makeSpot(Rook, White, true);
+        game.board[3 + 0 * 8] = makeSpot(Rook, Black, true);
+        game.updateBitboards();
+        // RxR pxR RxP(x-ray) RxR: White gets a rook and a pawn for two rooks, so stops at 0
+        CHECK(game.see(Move(3, 5, 3, 2, 0)) == 0);
+        game.board[2 + 1 * 8] = Empty;
+        game.updateBitboards();
+        // without the pawn Black runs out of defenders first
+        CHECK(game.see(Move(3, 5, 3, 2, 0)) == rook);
+
+        // a king can't take back when the spot is still covered
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White);
+        game.board[4 + 0 * 8] = makeSpot(King, Black);
+        game.board[4 + 1 * 8] = makeSpot(Pawn, Black, true);
+        game.board[4 + 4 * 8] = makeSpot(Rook, White, true);
+        game.board[4 + 5 * 8] = makeSpot(Rook, White, true);
+        game.updateBitboards();
+        CHECK(game.see(Move(4, 4, 4, 1, 0)) == pawn);
+        game.board[4 + 5 * 8] = Empty;
+        game.updateBitboards();
+        CHECK(game.see(Move(4, 4, 4, 1, 0)) == pawn - rook);
+    }
+
+    TEST_CASE("chess::Board::isSquareAttacked") {
+        Board game;
+
+        // new game: the third rows are covered, the middle of the board is not
+        CHECK(game.isSquareAttacked(4 + 5 * 8, White));
+        CHECK(game.isSquareAttacked(4 + 2 * 8, Black));
+        CHECK(!game.isSquareAttacked(4 + 4 * 8, White));
+        CHECK(!game.isSquareAttacked(4 + 3 * 8, Black));
+        CHECK(!game.kingIsInCheck(White));
+        CHECK(!game.kingIsInCheck(Black));
+
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White);
+        game.board[4 + 0 * 8] = makeSpot(King, Black);
+        game.board[0 + 4 * 8] = makeSpot(Rook, Black);
+        game.board[2 + 4 * 8] = makeSpot(Pawn, White);
+        game.ndxKing1 = 4 + 7 * 8;
+        game.ndxKing2 = 4 + 0 * 8;
+        game.generateMoveLists();
+
+        // the rook is blocked by the pawn and the pawn only attacks diagonally
+        CHECK(game.isSquareAttacked(1 + 4 * 8, Black));
+        CHECK(game.isSquareAttacked(2 + 4 * 8, Black));
+        CHECK(!game.isSquareAttacked(3 + 4 * 8, Black));
+        CHECK(game.isSquareAttacked(3 + 3 * 8, White));
+        CHECK(!game.isSquareAttacked(2 + 3 * 8, White));
+
+        // sliding and stepping checks
+        game.board[4 + 4 * 8] = makeSpot(Queen, Black);
+        game.generateMoveLists();
+        CHECK(game.kingIsInCheck(White));
+        CHECK(!game.kingIsInCheck(Black));
+        game.board[4 + 5 * 8] = makeSpot(Bishop, White);
+        game.generateMoveLists();
+        CHECK(!game.kingIsInCheck(White));
+        game.board[5 + 5 * 8] = makeSpot(Knight, Black);
+        game.generateMoveLists();
+        CHECK(game.kingIsInCheck(White));
+        game.board[5 + 5 * 8] = Empty;
+        game.board[3 + 6 * 8] = makeSpot(Pawn, Black);
+        game.generateMoveLists();
+        CHECK(game.kingIsInCheck(White));
+    }
+
+    /**
+     * check that the legal move generator agrees with making and checking every move
+     *
+     */
+    static void checkLegalMoves(Board const &game, Color side, size_t expected) {
+        MoveList pseudo = game.getMoves(side, false);
+        MoveList const slow = game.cleanupMoves(pseudo, side);
+        MoveList const fast = game.getLegalMoves(side);
+
+        CHECK(fast.size() == expected);
+        CHECK(fast.size() == slow.size());
+        for (Move const &move : slow) {
+            CHECK(find(fast.begin(), fast.end(), move) != fast.end());
+        }
+    }
+
+    /**
+     * unit tests for the pin and check aware move generator
+     *
+     */
+    TEST_CASE("chess::Board::getLegalMoves") {
+        Board game;
+        checkLegalMoves(game, White, 20);
+        checkLegalMoves(game, Black, 20);
+
+        // white rook pinned on the column by the black rook can only move along it
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White, true);
+        game.board[4 + 5 * 8] = makeSpot(Rook, White, true);
+        game.board[4 + 1 * 8] = makeSpot(Rook, Black, true);
+        game.board[0 + 0 * 8] = makeSpot(King, Black, true);
+        game.ndxKing1 = 4 + 7 * 8;
+        game.ndxKing2 = 0 + 0 * 8;
+        game.generateMoveLists();
+        checkLegalMoves(game, White, 5 + 5);
+
+        // single check by the rook: capture it, block it or step aside
+        game.board[4 + 5 * 8] = Empty;
+        game.board[2 + 4 * 8] = makeSpot(Bishop, White, true);
+        game.generateMoveLists();
+        CHECK(game.kingIsInCheck(White));
+        checkLegalMoves(game, White, 4 + 2);
+
+        // double check by rook and knight: only the king can move
+        game.board[3 + 5 * 8] = makeSpot(Knight, Black, true);
+        game.generateMoveLists();
+        checkLegalMoves(game, White, 3);
+
+        // en passant capture that would expose the king along the row is not allowed
+        game.board.fill(Empty);
+        game.board[0 + 3 * 8] = makeSpot(King, White, true);
+        game.board[1 + 3 * 8] = makeSpot(Pawn, White, true);
+        game.board[2 + 3 * 8] = makeSpot(Pawn, Black, true);
+        game.board[7 + 3 * 8] = makeSpot(Rook, Black, true);
+        game.board[7 + 0 * 8] = makeSpot(King, Black, true);
+        game.ndxKing1 = 0 + 3 * 8;
+        game.ndxKing2 = 7 + 0 * 8;
+        game.history.clear();
+        game.history.emplace_back(Move(2, 1, 2, 3, 0));
+        game.generateMoveLists();
+        checkLegalMoves(game, White, 3 + 1);
+    }
+
+    /**
+     * unit tests for finding any legal move without generating the move lists
+     *
+     */
+    TEST_CASE("chess::Board::hasLegalMove") {
+        // Black's rook in the corner can't move but the knight next to it can
+        Board game;
+        Move move(5, 6, 5, 5, 0);
+        game.executeMove(move);
+        game.nextTurn();
+        CHECK(game.hasLegalMove(Black));
+        CHECK(game.hasLegalMove(White));
+        CHECK(!game.moves1Ready);
+        CHECK(!game.moves2Ready);
+
+        // fool's mate
+        for (Move next : {Move(4, 1, 4, 3, 0), Move(6, 6, 6, 4, 0), Move(3, 0, 7, 4, 0)}) {
+            game.executeMove(next);
+            game.nextTurn();
+        }
+        CHECK(!game.hasLegalMove(White));
+        CHECK(game.hasLegalMove(Black));
+        CHECK(game.getMoves1().empty());
+
+        // the lists are used once they are there
+        game.moves1.push_back(Move(0, 0, 0, 1, 0));
+        CHECK(game.hasLegalMove(White));
+
+        // Black's king has nowhere to go but isn't in check
+        game.board.fill(Empty);
+        game.board[0 + 0 * 8] = makeSpot(King, Black, true);
+        game.board[2 + 1 * 8] = makeSpot(Queen, White, true);
+        game.board[4 + 7 * 8] = makeSpot(King, White, true);
+        game.ndxKing1 = 4 + 7 * 8;
+        game.ndxKing2 = 0 + 0 * 8;
+        game.generateMoveLists();
+        CHECK(!game.kingIsInCheck(Black));
+        CHECK(!game.hasLegalMove(Black));
+        CHECK(game.hasLegalMove(White));
+    }
 }  // namespace chess
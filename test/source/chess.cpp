@@ -6,6 +6,7 @@
 #endif
 
 #include <board.h>
+#include <evaluator.h>
 #include <minimax.h>
 
 #include <algorithm>
@@ -305,4 +306,512 @@ namespace chess {
         CHECK(!game.kingIsInCheck(White));
 #endif
     }
+
+    TEST_CASE("chess::Minimax iterative deepening") {
+        Board game;
+        game.generateMoveLists();
+
+        Minimax plain(2);
+        plain.useThreads = false;
+        plain.timeout = 0;
+        Move const plainMove = plain.bestMove(game);
+
+        Minimax deepening(2);
+        deepening.useThreads = false;
+        deepening.useIterativeDeepening = true;
+        deepening.timeout = 0;
+        Move const move = deepening.bestMove(game);
+
+        // the last iteration searches to the same depth so it finds the same value
+        CHECK(move.isValid(game));
+        CHECK(deepening.maxDepth == 2);
+        CHECK(move.getValue() == plainMove.getValue());
+
+        // the principal variation starts with the best move and runs one move per ply
+        REQUIRE(!deepening.pv.empty());
+        CHECK(deepening.pv[0] == move);
+        CHECK(deepening.pv.size() >= 3);
+
+        // with threads every root move still reaches the same values
+        deepening.useThreads = true;
+        Move const threaded = deepening.bestMove(game);
+        CHECK(threaded.getValue() == move.getValue());
+        CHECK(deepening.pv[0] == threaded);
+    }
+
+    TEST_CASE("chess::Minimax timeout") {
+        Board game;
+        game.generateMoveLists();
+
+        for (bool const negamax : {false, true}) {
+            // far too deep to finish in the time allowed
+            Minimax timed(5);
+            timed.useThreads = false;
+            timed.useNegamax = negamax;
+            timed.useCache = true;
+            timed.cacheSize = 1;
+            timed.timeout = 1;
+            Move const move = timed.bestMove(game);
+            CHECK(move.isValid(game));
+
+            // the boards cut short by the timeout keep nothing in the table so every exact
+            // entry left for a root move is the value a full search finds
+            for (Move reply : game.getMoves1()) {
+                Board child(game);
+                child.executeMove(reply);
+                child.nextTurn();
+                TTEntry const entry = timed.cache.probe(child.getHash());
+                if (!entry.isValid() || entry.bound != TTEntry::Exact) continue;
+
+                Minimax full(entry.depth);
+                full.useThreads = false;
+                CHECK(full.minmax(child, MIN_VALUE, MAX_VALUE, entry.depth, false)
+                      == entry.score);
+            }
+        }
+    }
+
+    TEST_CASE("chess::Minimax negamax") {
+        Board game;
+        game.generateMoveLists();
+
+        Minimax plain(2);
+        plain.useThreads = false;
+        Move const plainMove = plain.bestMove(game);
+
+        Minimax pvs(2);
+        pvs.useThreads = false;
+        pvs.useNegamax = true;
+        Move move = pvs.bestMove(game);
+
+        // the same value and move as the minmax search, from fewer positions
+        CHECK(move.isValid(game));
+        CHECK(move.getValue() == plainMove.getValue());
+        CHECK(move == plainMove);
+        CHECK(pvs.movesExamined < plain.movesExamined);
+        REQUIRE(!pvs.pv.empty());
+        CHECK(pvs.pv[0] == move);
+
+        // Black's scores are negated inside the search but come back white-positive
+        game.executeMove(move);
+        game.advanceTurn();
+        Move const plainReply = plain.bestMove(game);
+        Move const reply = pvs.bestMove(game);
+        CHECK(reply.getValue() == plainReply.getValue());
+        CHECK(reply == plainReply);
+    }
+
+    TEST_CASE("chess::Minimax aspiration windows") {
+        Board game;
+        game.generateMoveLists();
+        PieceMap pieceMap;
+
+        Minimax plain(2);
+        plain.useThreads = false;
+        Move const plainMove = plain.bestMove(game);
+
+        Minimax agent(2);
+        agent.useThreads = false;
+        agent.useAspiration = true;
+        agent.aspirationWindow = 10;
+
+        // expecting far too much: the window fails low until it widens enough
+        Move move = agent.searchRoot(game, game.getMoves1(), true, pieceMap,
+                                     plainMove.getValue() + 1'000, true);
+        CHECK(move.getValue() == plainMove.getValue());
+        CHECK(agent.failLows > 0);
+        CHECK(agent.failHighs == 0);
+
+        // expecting far too little fails high instead
+        int const failLows = agent.failLows;
+        move = agent.searchRoot(game, game.getMoves1(), true, pieceMap,
+                                plainMove.getValue() - 1'000, true);
+        CHECK(move.getValue() == plainMove.getValue());
+        CHECK(agent.failHighs > 0);
+        CHECK(agent.failLows == failLows);
+
+        // the right guess needs no second search
+        int const failHighs = agent.failHighs;
+        move = agent.searchRoot(game, game.getMoves1(), true, pieceMap, plainMove.getValue(),
+                                true);
+        CHECK(move == plainMove);
+        CHECK(agent.failHighs == failHighs);
+        CHECK(agent.failLows == failLows);
+    }
+
+    TEST_CASE("chess::Minimax null move pruning") {
+        Board game;
+        game.generateMoveLists();
+
+        Minimax pvs(4);
+        pvs.useThreads = false;
+        pvs.useNegamax = true;
+        Move const pvsMove = pvs.bestMove(game);
+
+        Minimax pruning(pvs);
+        pruning.useNullMove = true;
+        Move const move = pruning.bestMove(game);
+
+        CHECK(move.isValid(game));
+        CHECK(pruning.movesExamined < pvs.movesExamined);
+
+        // a reduction as deep as the search leaves nothing to prune
+        pruning.nullMoveReduction = 4;
+        Move const unpruned = pruning.bestMove(game);
+        CHECK(unpruned == pvsMove);
+        CHECK(pruning.movesExamined == pvs.movesExamined);
+    }
+
+    TEST_CASE("chess::Minimax late move reductions") {
+        // the first moves are never reduced and later ones more the deeper and later they are
+        for (int depth = 1; depth < 64; depth++) {
+            CHECK(Minimax::lateMoveReduction(depth, 1) == 0);
+            CHECK(Minimax::lateMoveReduction(depth, 3) == 0);
+        }
+        CHECK(Minimax::lateMoveReduction(3, 4) >= 1);
+        CHECK(Minimax::lateMoveReduction(8, 40) > Minimax::lateMoveReduction(3, 4));
+        CHECK(Minimax::lateMoveReduction(20, 40) >= Minimax::lateMoveReduction(8, 40));
+        CHECK(Minimax::lateMoveReduction(8, 400) == Minimax::lateMoveReduction(8, 63));
+
+        Board game;
+        game.generateMoveLists();
+
+        Minimax pvs(4);
+        pvs.useThreads = false;
+        pvs.useNegamax = true;
+        pvs.bestMove(game);
+
+        Minimax reducing(pvs);
+        reducing.useLateMoveReductions = true;
+        Move const move = reducing.bestMove(game);
+        CHECK(move.isValid(game));
+        CHECK(reducing.movesExamined < pvs.movesExamined);
+    }
+
+    TEST_CASE("chess::Minimax killer moves and history") {
+        Board game;
+        game.generateMoveLists();
+
+        Minimax plain(3);
+        plain.useThreads = false;
+        Move const plainMove = plain.bestMove(game);
+        CHECK(plain.cutoffs > 0);
+        CHECK(plain.firstMoveCutoffs <= plain.cutoffs);
+
+        // better ordered moves reach the same value with fewer moves and earlier cutoffs
+        Minimax ordered(3);
+        ordered.useThreads = false;
+        ordered.useKillers = true;
+        Move const move = ordered.bestMove(game);
+        CHECK(move == plainMove);
+        CHECK(move.getValue() == plainMove.getValue());
+        CHECK(ordered.movesExamined < plain.movesExamined);
+        CHECK(ordered.firstMoveCutoffs * plain.cutoffs > plain.firstMoveCutoffs * ordered.cutoffs);
+
+        // each thread keeps its own and they all count
+        Minimax threaded(ordered);
+        threaded.useThreads = true;
+        threaded.cutoffs = 0;
+        threaded.bestMove(game);
+        CHECK(threaded.cutoffs > 0);
+    }
+
+    TEST_CASE("chess::Minimax static exchange") {
+        // 1. e4 d5 2. Nc3 Nf6 leaves captures on both sides
+        Board game;
+        for (Move move : {Move(4, 6, 4, 4, 0), Move(3, 1, 3, 3, 0), Move(1, 7, 2, 5, 0),
+                          Move(6, 0, 5, 2, 0)}) {
+            game.executeMove(move);
+            game.advanceTurn();
+        }
+
+        Minimax plain(3);
+        plain.useThreads = false;
+        plain.useNegamax = true;
+        plain.useMovePicker = true;
+        plain.bestMove(game);
+
+        // losing captures are searched last and pruned near the leaves
+        Minimax seen(plain);
+        seen.useSee = true;
+        Move const move = seen.bestMove(game);
+        CHECK(move.isValid(game));
+        CHECK(move.isCapture());
+        CHECK(game.see(move) >= 0);
+        CHECK(seen.movesExamined < plain.movesExamined);
+    }
+
+    TEST_CASE("chess::Minimax quiescence") {
+        Board game;
+        game.generateMoveLists();
+
+        // nothing to capture so the board stands as it is
+        Minimax agent(2);
+        agent.useThreads = false;
+        agent.useQuiescence = true;
+        CHECK(agent.quiesce(game, MIN_VALUE, MAX_VALUE) == Evaluator::evaluate(game));
+        CHECK(agent.countNodes() == 0);
+
+        // the queen takes the loose knight and leaves the pawn a pawn defends
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White);
+        game.board[4 + 0 * 8] = makeSpot(King, Black);
+        game.board[3 + 4 * 8] = makeSpot(Queen, White, true);
+        game.board[1 + 4 * 8] = makeSpot(Knight, Black, true);
+        game.board[6 + 4 * 8] = makeSpot(Pawn, Black, true);
+        game.board[7 + 3 * 8] = makeSpot(Pawn, Black, true);
+        game.turn = White;
+        game.generateMoveLists();
+
+        Board taken(game);
+        Move capture(3, 4, 1, 4, 0);
+        taken.executeMove(capture);
+        taken.advanceTurn();
+        CHECK(agent.quiesce(game, MIN_VALUE, MAX_VALUE) == Evaluator::evaluate(taken));
+        CHECK(agent.countNodes() > 0);
+
+        // Black to move scores for Black
+        game.turn = Black;
+        game.generateMoveLists();
+        CHECK(agent.quiesce(game, MIN_VALUE, MAX_VALUE) == -Evaluator::evaluate(game));
+
+        // minmax and negamax hand off to the same search and agree
+        Board start;
+        start.generateMoveLists();
+        Move const move = agent.bestMove(start);
+        Minimax pvs(agent);
+        pvs.useNegamax = true;
+        Move const pvsMove = pvs.bestMove(start);
+        CHECK(move.isValid(start));
+        CHECK(pvsMove == move);
+        CHECK(pvsMove.getValue() == move.getValue());
+    }
+
+    TEST_CASE("chess::Minimax futility pruning") {
+        Board game;
+        game.generateMoveLists();
+
+        Minimax plain(3);
+        plain.useThreads = false;
+        plain.useNegamax = true;
+        plain.useMovePicker = true;
+        Move const plainMove = plain.bestMove(game);
+
+        // margins too wide to ever apply prune nothing
+        Minimax wide(plain);
+        wide.useFutility = true;
+        wide.futilityMargin = wide.reverseFutilityMargin = wide.razorMargin = 1'000'000;
+        Move const wideMove = wide.bestMove(game);
+        CHECK(wideMove == plainMove);
+        CHECK(wideMove.getValue() == plainMove.getValue());
+        CHECK(wide.movesExamined == plain.movesExamined);
+
+        // the usual margins prune frontier boards far from the window
+        Minimax pruned(plain);
+        pruned.useFutility = true;
+        Move const move = pruned.bestMove(game);
+        CHECK(move.isValid(game));
+        CHECK(pruned.movesExamined < plain.movesExamined);
+    }
+
+    TEST_CASE("chess::Minimax lazy smp") {
+        Board game;
+        game.generateMoveLists();
+
+        // copied before the search so each starts with an empty table
+        Minimax single(3);
+        single.useThreads = false;
+        single.useCache = true;
+        single.cacheSize = 1;
+        single.useNegamax = true;
+        single.useMovePicker = true;
+        Minimax smp(single);
+        Minimax alone(single);
+        Minimax minmaxSmp(single);
+        Move const singleMove = single.bestMove(game);
+
+        // the helpers fill the shared table alongside the main search and stop with it
+        smp.useLazySmp = true;
+        smp.numThreads = 4;
+        Move const move = smp.bestMove(game);
+        CHECK(move.isValid(game));
+        CHECK(smp.cache.countStores() > single.cache.countStores());
+        CHECK(smp.pv.size() > 1);
+        CHECK(smp.pv[0] == move);
+
+        // on its own the main thread is the same search as searchWithNoThreads(...)
+        alone.useLazySmp = true;
+        alone.numThreads = 1;
+        Move const aloneMove = alone.bestMove(game);
+        CHECK(aloneMove == singleMove);
+        CHECK(aloneMove.getValue() == singleMove.getValue());
+        CHECK(alone.movesExamined == single.movesExamined);
+
+        // with minmax as well
+        minmaxSmp.useNegamax = false;
+        minmaxSmp.useLazySmp = true;
+        minmaxSmp.numThreads = 3;
+        CHECK(minmaxSmp.bestMove(game).isValid(game));
+    }
+
+    TEST_CASE("chess::Minimax ybwc") {
+        Board game;
+        for (Move move : {Move(4, 6, 4, 4, 0), Move(3, 1, 3, 3, 0)}) {
+            game.executeMove(move);
+            game.advanceTurn();
+        }
+
+        Minimax single(3);
+        single.useThreads = false;
+        single.useNegamax = true;
+        single.useMovePicker = true;
+        Move const singleMove = single.bestMove(game);
+
+        // splitting the work changes the order moves are searched in but not the value
+        Minimax ybwc(single);
+        ybwc.useYbwc = true;
+        ybwc.numThreads = 4;
+        Move const move = ybwc.bestMove(game);
+        CHECK(move.isValid(game));
+        CHECK(move.getValue() == singleMove.getValue());
+        REQUIRE(ybwc.pv.size() > 1);
+        CHECK(ybwc.pv[0] == move);
+
+        // with no helpers nothing is split
+        Minimax alone(single);
+        alone.useYbwc = true;
+        alone.numThreads = 1;
+        Move const aloneMove = alone.bestMove(game);
+        CHECK(aloneMove == singleMove);
+        CHECK(alone.movesExamined == single.movesExamined);
+
+        // Black's turn, with the search's pruning on as well
+        Move played = move;
+        game.executeMove(played);
+        game.advanceTurn();
+        ybwc.useNullMove = true;
+        ybwc.useLateMoveReductions = true;
+        ybwc.useSee = true;
+        Move const reply = ybwc.bestMove(game);
+        CHECK(reply.isValid(game));
+        CHECK(ybwc.pv[0] == reply);
+    }
+
+    TEST_CASE("chess::Minimax shared root window") {
+        Board game;
+        for (Move move : {Move(4, 6, 4, 4, 0), Move(3, 1, 3, 3, 0)}) {
+            game.executeMove(move);
+            game.advanceTurn();
+        }
+
+        // both sides to move, with minmax and with negamax
+        for (int const turn : {0, 1}) {
+            for (bool const negamax : {false, true}) {
+                Minimax apart(3);
+                apart.useThreads = true;
+                apart.useNegamax = negamax;
+                apart.numThreads = 1;
+                Move const apartMove = apart.bestMove(game);
+
+                // one thread takes the root moves in order so every one after the best one
+                // so far is cut short
+                Minimax shared(apart);
+                shared.useSharedWindow = true;
+                Move const move = shared.bestMove(game);
+                CHECK(move == apartMove);
+                CHECK(move.getValue() == apartMove.getValue());
+                CHECK(std::equal(shared.pv.begin(), shared.pv.end(), apart.pv.begin(),
+                                 apart.pv.end()));
+                CHECK(shared.movesExamined < apart.movesExamined);
+
+                // whatever order the threads finish in
+                Minimax many(shared);
+                many.numThreads = 4;
+                Move const manyMove = many.bestMove(game);
+                CHECK(manyMove == apartMove);
+                CHECK(manyMove.getValue() == apartMove.getValue());
+
+                // with the table as well it finds what a single thread does
+                Minimax alone(apart);
+                alone.useThreads = false;
+                alone.useCache = true;
+                Move const aloneMove = alone.bestMove(game);
+                Minimax cached(many);
+                cached.useCache = true;
+                Move const cachedMove = cached.bestMove(game);
+                CHECK(cachedMove == aloneMove);
+                CHECK(cachedMove.getValue() == aloneMove.getValue());
+            }
+
+            if (turn == 0) {
+                Move move(6, 0, 5, 2, 0);
+                game.executeMove(move);
+                game.advanceTurn();
+            }
+        }
+
+        // Boards cut off by the shared window (or with one cut off below them) leave nothing
+        // in the table, so what is there agrees with a full search.  Without the quiescent
+        // plies past captures a board's value doesn't depend on the moves that led to it.
+        for (bool const negamax : {false, true}) {
+            Minimax cached(4);
+            cached.useThreads = true;
+            cached.useNegamax = negamax;
+            cached.numThreads = 4;
+            cached.useSharedWindow = true;
+            cached.useCache = true;
+            cached.qMaxDepth = 0;
+            cached.bestMove(game);
+
+            for (Move first : game.getMoves1()) {
+                Board child(game);
+                child.executeMove(first);
+                child.nextTurn();
+                for (Move second : child.getMoves1()) {
+                    Board reply(child);
+                    reply.executeMove(second);
+                    reply.nextTurn();
+                    TTEntry const entry = cached.cache.probe(reply.getHash());
+                    if (!entry.isValid()) continue;
+
+                    Minimax full(entry.depth);
+                    full.qMaxDepth = 0;
+                    int const value = full.minmax(reply, MIN_VALUE, MAX_VALUE, entry.depth,
+                                                  reply.turn == White);
+                    if (entry.bound == TTEntry::Exact) CHECK(value == entry.score);
+                    if (entry.bound == TTEntry::Lower) CHECK(value >= entry.score);
+                    if (entry.bound == TTEntry::Upper) CHECK(value <= entry.score);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("chess::Minimax node counts") {
+        Board game;
+
+        // each root move is the same search on whichever thread it runs, so the counts
+        // kept on each thread add up to the same total
+        Minimax one(3);
+        one.useThreads = true;
+        one.numThreads = 1;
+        one.bestMove(game);
+        CHECK(one.movesExamined > 0);
+        CHECK(one.countNodes() == one.movesExamined);
+
+        Minimax many(one);
+        many.numThreads = 4;
+        many.bestMove(game);
+        CHECK(many.movesExamined == one.movesExamined);
+
+        // and the next search starts over
+        many.bestMove(game);
+        CHECK(many.movesExamined == one.movesExamined);
+
+        // a search only uses as many threads as it is given, however many the pool has
+        one.bestMove(game);
+        long const busy = std::count_if(
+            one.nodeCounts.begin(), one.nodeCounts.end(),
+            [](Minimax::NodeCount const &count) { return count.nodes > 0; });
+        CHECK(busy == 1);
+    }
 }  // namespace chess
@@ -37,17 +37,20 @@ namespace chess {
 
         board.board.fill(Empty);
         board.board[3 + 3 * 8] = makeSpot(Pawn, White);
+        board.updateBitboards();
         auto score = Evaluator::evaluate(board);
         CHECK(score > 0);
 
         board.board.fill(Empty);
         board.board[3 + 3 * 8] = makeSpot(Pawn, Black);
+        board.updateBitboards();
         score = Evaluator::evaluate(board);
         CHECK(score < 0);
 
         board.board.fill(Empty);
         board.board[3 + 3 * 8] = makeSpot(Pawn, White);
         board.board[4 + 4 * 8] = makeSpot(Pawn, Black);
+        board.updateBitboards();
         score = Evaluator::evaluate(board);
         CHECK(score == 0);
 
@@ -56,11 +59,13 @@ namespace chess {
         // start with piece in corner and save score
         board.board.fill(Empty);
         board.board[7 + 7 * 8] = makeSpot(Pawn, White);
+        board.updateBitboards();
         auto score1 = Evaluator::evaluate(board);
 
         // move closer towards the center horizontally
         board.board.fill(Empty);
         board.board[6 + 7 * 8] = makeSpot(Pawn, White);
+        board.updateBitboards();
         auto score2 = Evaluator::evaluate(board);
         CHECK(score2 > score1);  // closer should have a higher score
 
@@ -68,6 +73,7 @@ namespace chess {
         board.board.fill(Empty);
         // move closer towards the center horizontally
         board.board[4 + 7 * 8] = makeSpot(Pawn, White);
+        board.updateBitboards();
         score2 = Evaluator::evaluate(board);
         CHECK(score2 > score1);  // closer should have a higher score
 
@@ -75,6 +81,7 @@ namespace chess {
         board.board.fill(Empty);
         // move closer towards the center vertically
         board.board[4 + 6 * 8] = makeSpot(Pawn, White);
+        board.updateBitboards();
         score2 = Evaluator::evaluate(board);
         CHECK(score2 > score1);  // closer should have a higher score
 
@@ -82,6 +89,7 @@ namespace chess {
         board.board.fill(Empty);
         // move closer towards the center vertically
         board.board[4 + 4 * 8] = makeSpot(Pawn, White);
+        board.updateBitboards();
         score2 = Evaluator::evaluate(board);
         CHECK(score2 > score1);  // closer should have a higher score
     }
@@ -0,0 +1,66 @@
+#include <doctest/doctest.h>
+
+#if defined(_WIN32) || defined(WIN32)
+// apparently this is required to compile in MSVC++
+#    include <sstream>
+#endif
+
+#include <heuristics.h>
+
+namespace chess {
+    /**
+     * unit tests for the killer moves and history heuristic
+     *
+     */
+    TEST_CASE("chess::SearchHeuristics") {
+        SearchHeuristics heuristics;
+        Move const first(4, 6, 4, 4, 0);
+        Move const second(6, 7, 5, 5, 0);
+        Move const third(1, 7, 2, 5, 0);
+        Move const other(3, 6, 3, 4, 0);
+        CHECK(heuristics.score(White, first, 2) == 0);
+
+        // the newest quiet cutoff at a ply is its first killer and pushes the older one down
+        heuristics.addCutoff(White, first, 2, 3, 1);
+        heuristics.addCutoff(White, second, 2, 2, 4);
+        CHECK(heuristics.getKillers(2)[0] == second.getPacked());
+        CHECK(heuristics.getKillers(2)[1] == first.getPacked());
+        CHECK(heuristics.score(White, second, 2) == SearchHeuristics::KillerScore);
+        CHECK(heuristics.score(White, first, 2) == SearchHeuristics::KillerScore - 1);
+
+        heuristics.addCutoff(White, third, 2, 1, 2);
+        CHECK(heuristics.getKillers(2)[0] == third.getPacked());
+        CHECK(heuristics.getKillers(2)[1] == second.getPacked());
+
+        // off their ply the killers are scored by history: depth squared per cutoff and side
+        CHECK(heuristics.score(White, first, 3) == 9);
+        CHECK(heuristics.score(White, second, 3) == 4);
+        CHECK(heuristics.score(Black, first, 3) == 0);
+        CHECK(heuristics.score(White, other, 2) == 0);
+
+        // captures only count in the statistics
+        Move capture(3, 4, 2, 3, 0);
+        capture.setCaptured(makeSpot(Rook, Black));
+        heuristics.addCutoff(White, capture, 2, 5, 1);
+        CHECK(heuristics.getKillers(2)[0] == third.getPacked());
+        CHECK(heuristics.score(White, capture, 3) == 0);
+        CHECK(heuristics.cutoffs == 4);
+        CHECK(heuristics.firstMoveCutoffs == 2);
+
+        // plies past the last one kept have no killers
+        heuristics.addCutoff(White, other, SearchHeuristics::MaxPly, 1, 1);
+        CHECK(!Move(heuristics.getKillers(SearchHeuristics::MaxPly)[0]).isValid());
+        CHECK(heuristics.score(White, other, SearchHeuristics::MaxPly) == 1);
+
+        // a full history table halves so newer cutoffs can catch up
+        for (int count = 0; count < 40; count++) {
+            heuristics.addCutoff(Black, other, 10, 200, 1);
+        }
+        CHECK(heuristics.score(Black, other, 3) <= SearchHeuristics::HistoryMax);
+        CHECK(heuristics.score(Black, other, 3) > SearchHeuristics::HistoryMax / 2);
+
+        heuristics.clear();
+        CHECK(heuristics.score(White, second, 2) == 0);
+        CHECK(heuristics.cutoffs == 0);
+    }
+}  // namespace chess
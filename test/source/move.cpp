@@ -48,5 +48,75 @@ namespace chess {
         move1 = Move(4, 1, 4, 2, 0);
         CHECK(move1.isValid(game));
         CHECK(move1.isValid());
+
+        // packed moves keep the spots, flag and promotion piece in 16 bits
+        PackedMove packed(12, 4, PackedMove::Promotion, Knight);
+        CHECK(packed.getFrom() == 12);
+        CHECK(packed.getTo() == 4);
+        CHECK(packed.getFlag() == PackedMove::Promotion);
+        CHECK(packed.getPromotion() == Knight);
+        CHECK(packed != PackedMove(12, 4));
+        CHECK(PackedMove(63, 0, PackedMove::Castle).getFrom() == 63);
+        CHECK(PackedMove(63, 0, PackedMove::Castle).getFlag() == PackedMove::Castle);
+
+        move1 = Move(packed, 500);
+        CHECK(move1.getFromCol() == 4);
+        CHECK(move1.getFromRow() == 1);
+        CHECK(move1.getToCol() == 4);
+        CHECK(move1.getToRow() == 0);
+        CHECK(move1.isPromotion());
+        CHECK(move1.getPromotion() == Knight);
+        CHECK(move1.getValue() == 500);
+        CHECK(move1.getPacked() == packed);
+        CHECK(move1 == Move(4, 1, 4, 0, 0));
+
+        // under promotion
+        game.board.fill(Empty);
+        game.board[4 + 1 * 8] = makeSpot(Pawn, White);
+        game.updateBitboards();
+        game.executeMove(move1);
+        CHECK(game.getType(4) == Knight);
+    }
+
+    /**
+     * unit tests for the fixed capacity MoveList
+     *
+     */
+    TEST_CASE("chess::MoveList") {
+        MoveList moves;
+        CHECK(moves.empty());
+        CHECK(moves.capacity() == MAX_MOVES);
+
+        moves.emplace_back(1, 2, 3, 4, 30);
+        moves.push_back(Move(5, 6, 7, 0, 10));
+        moves.emplace_back(0, 1, 0, 2, 20);
+        CHECK(moves.size() == 3);
+        CHECK(moves.front().getValue() == 30);
+        CHECK(moves.back().getValue() == 20);
+
+        // copies only share values, not storage
+        MoveList copy = moves;
+        copy[0].setValue(99);
+        CHECK(moves[0].getValue() == 30);
+        CHECK(copy.size() == 3);
+
+        sort(moves.begin(), moves.end(),
+             [](Move const &a, Move const &b) { return a.getValue() < b.getValue(); });
+        CHECK(moves[0].getValue() == 10);
+        CHECK(moves[2].getValue() == 30);
+
+        moves.erase(moves.begin(), moves.begin() + 2);
+        CHECK(moves.size() == 1);
+        CHECK(moves[0].getValue() == 30);
+        moves.pop_back();
+        CHECK(moves.empty());
+
+        // items past the capacity are dropped
+        for (unsigned int i = 0; i <= MAX_MOVES; ++i) {
+            moves.emplace_back(0, 1, 0, 2, 0);
+        }
+        CHECK(moves.size() == MAX_MOVES);
+        moves.clear();
+        CHECK(moves.empty());
     }
 }  // namespace chess
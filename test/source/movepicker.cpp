@@ -0,0 +1,136 @@
+#include <doctest/doctest.h>
+
+#if defined(_WIN32) || defined(WIN32)
+// apparently this is required to compile in MSVC++
+#    include <sstream>
+#endif
+
+#include <board.h>
+#include <movepicker.h>
+
+namespace chess {
+    /**
+     * pick every move and check that each of the board's legal moves comes out exactly once
+     *
+     */
+    static MoveList pickAll(MovePicker &picker, Board const &game) {
+        MoveList picked;
+        Move move;
+        while (picker.next(move)) {
+            CHECK(find(picked.begin(), picked.end(), move) == picked.end());
+            picked.push_back(move);
+        }
+        CHECK(picked.size() == game.moves1.size());
+        for (Move const &legal : game.moves1) {
+            CHECK(find(picked.begin(), picked.end(), legal) != picked.end());
+        }
+        return picked;
+    }
+
+    /**
+     * unit tests for the staged MovePicker
+     *
+     */
+    TEST_CASE("chess::MovePicker") {
+        // a new game has no captures so the moves come out in the order they are generated
+        Board game;
+        MovePicker picker(game);
+        MoveList picked = pickAll(picker, game);
+        CHECK(picked[0] == game.getMoves(White, true)[0]);
+
+        // walking a list hands it out as is
+        MovePicker listPicker(game.moves1);
+        Move move;
+        for (Move const &listed : game.moves1) {
+            CHECK(listPicker.next(move));
+            CHECK(move == listed);
+        }
+        CHECK(!listPicker.next(move));
+
+        // with heuristics quiet moves come out killers first and then by history
+        SearchHeuristics heuristics;
+        Move const killer(6, 7, 5, 5, 0);
+        Move const often(1, 6, 1, 5, 0);
+        heuristics.addCutoff(White, often, 4, 3, 1);
+        heuristics.addCutoff(White, killer, 1, 1, 1);
+        MovePicker orderedPicker(game, Move(), &heuristics, 1);
+        picked = pickAll(orderedPicker, game);
+        CHECK(picked[0] == killer);
+        CHECK(picked[1] == often);
+
+        MovePicker orderedList(game.moves1, Move(), &heuristics, White, 1);
+        CHECK(orderedList.next(move));
+        CHECK(move == killer);
+        CHECK(orderedList.next(move));
+        CHECK(move == often);
+
+        MovePicker orderedHash(game.moves1, often, &heuristics, White, 1);
+        CHECK(orderedHash.next(move));
+        CHECK(move == often);
+        CHECK(orderedHash.next(move));
+        CHECK(move == killer);
+
+        // captures come first: most valuable victim, then least valuable attacker
+        game.board.fill(Empty);
+        game.board[4 + 7 * 8] = makeSpot(King, White);
+        game.board[4 + 0 * 8] = makeSpot(King, Black);
+        game.board[3 + 4 * 8] = makeSpot(Pawn, White, true);
+        game.board[3 + 5 * 8] = makeSpot(Rook, White, true);
+        game.board[2 + 3 * 8] = makeSpot(Rook, Black, true);
+        game.board[4 + 3 * 8] = makeSpot(Knight, Black, true);
+        game.board[7 + 4 * 8] = makeSpot(Queen, White, true);
+        game.board[7 + 3 * 8] = makeSpot(Pawn, Black, true);
+        game.turn = White;
+        game.generateMoveLists();
+
+        MovePicker capturePicker(game);
+        picked = pickAll(capturePicker, game);
+        CHECK(picked[0] == Move(3, 4, 2, 3, 0));  // pawn takes rook
+        CHECK(picked[1] == Move(3, 4, 4, 3, 0));  // pawn takes knight
+        CHECK(picked[2] == Move(7, 4, 7, 3, 0));  // queen takes pawn
+        CHECK(game.isEmpty(picked[3].getTo()));
+        CHECK(game.getMoves(White, true, game.getOccupied(Black)).size() == 3);
+
+        // a legal hash move comes out first and only once
+        Move const hashMove(3, 5, 3, 7, 0);
+        MovePicker hashPicker(game, hashMove);
+        picked = pickAll(hashPicker, game);
+        CHECK(picked[0] == hashMove);
+        CHECK(picked[1] == Move(3, 4, 2, 3, 0));
+
+        // an illegal one is ignored
+        MovePicker badHashPicker(game, Move(3, 5, 3, 3, 0));
+        picked = pickAll(badHashPicker, game);
+        CHECK(picked[0] == Move(3, 4, 2, 3, 0));
+
+        // so is one that moves a pinned piece off the line to its king
+        Board pinned(game);
+        pinned.board.fill(Empty);
+        pinned.board[4 + 7 * 8] = makeSpot(King, White);
+        pinned.board[4 + 0 * 8] = makeSpot(King, Black);
+        pinned.board[4 + 5 * 8] = makeSpot(Rook, White, true);
+        pinned.board[4 + 2 * 8] = makeSpot(Rook, Black, true);
+        pinned.turn = White;
+        pinned.generateMoveLists();
+        MovePicker pinnedPicker(pinned, Move(4, 5, 2, 5, 0));
+        picked = pickAll(pinnedPicker, pinned);
+        CHECK(!(picked[0] == Move(4, 5, 2, 5, 0)));
+        MovePicker linePicker(pinned, Move(4, 5, 4, 3, 0));
+        picked = pickAll(linePicker, pinned);
+        CHECK(picked[0] == Move(4, 5, 4, 3, 0));
+
+        // with see a capture that loses material waits until after the quiet moves
+        game.board[6 + 2 * 8] = makeSpot(Pawn, Black, true);
+        game.generateMoveLists();
+        MovePicker seePicker(game, Move(), nullptr, 0, true);
+        picked = pickAll(seePicker, game);
+        CHECK(picked[0] == Move(3, 4, 2, 3, 0));
+        CHECK(picked[1] == Move(3, 4, 4, 3, 0));
+        CHECK(game.isEmpty(picked[2].getTo()));
+        CHECK(picked.back() == Move(7, 4, 7, 3, 0));
+
+        MovePicker plainPicker(game);
+        picked = pickAll(plainPicker, game);
+        CHECK(picked[2] == Move(7, 4, 7, 3, 0));
+    }
+}  // namespace chess
@@ -0,0 +1,66 @@
+#include <doctest/doctest.h>
+
+#if defined(_WIN32) || defined(WIN32)
+// apparently this is required to compile in MSVC++
+#    include <sstream>
+#endif
+
+#include <threadpool.h>
+
+#include <atomic>
+#include <stdexcept>
+
+namespace chess {
+    /**
+     * unit tests for the search thread pool
+     *
+     */
+    TEST_CASE("chess::ThreadPool") {
+        // with no workers a task runs on the thread that submits it
+        ThreadPool none;
+        CHECK(none.size() == 0);
+        auto const here = std::this_thread::get_id();
+        CHECK(none.submit([]() { return std::this_thread::get_id(); }).get() == here);
+
+        ThreadPool pool(2);
+        CHECK(pool.size() == 2);
+        pool.reserve(1);
+        CHECK(pool.size() == 2);
+        pool.reserve(ThreadPool::MaxThreads + 1);
+        CHECK(pool.size() == ThreadPool::MaxThreads);
+
+        // every task runs once and hands back its own result
+        std::atomic<int> ran{0};
+        vector<future<int>> results;
+        for (int ndx = 0; ndx < 100; ndx++) {
+            results.emplace_back(pool.submit([ndx, &ran]() {
+                ran++;
+                return ndx * ndx;
+            }));
+        }
+        int sum = 0;
+        for (auto &result : results) sum += result.get();
+        CHECK(ran == 100);
+        CHECK(sum == 328'350);
+
+        // tasks a worker adds go on its own queue, where the other workers steal them while
+        // it waits for them
+        auto stolen = pool.submit([&pool]() {
+            auto const self = std::this_thread::get_id();
+            vector<future<bool>> inner;
+            for (int ndx = 0; ndx < 8; ndx++) {
+                inner.emplace_back(
+                    pool.submit([self]() { return std::this_thread::get_id() != self; }));
+            }
+            bool allStolen = true;
+            for (auto &result : inner) allStolen = result.get() && allStolen;
+            return allStolen;
+        });
+        CHECK(stolen.get());
+
+        // an exception in a task comes out of its future
+        auto failed = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+        CHECK_THROWS_AS(failed.get(), std::runtime_error);
+    }
+
+}  // namespace chess
@@ -0,0 +1,121 @@
+#include <doctest/doctest.h>
+
+#if defined(_WIN32) || defined(WIN32)
+// apparently this is required to compile in MSVC++
+#    include <sstream>
+#endif
+
+#include <board.h>
+#include <minimax.h>
+#include <threadpool.h>
+#include <transposition.h>
+
+namespace chess {
+    /**
+     * unit tests for TranspositionTable class
+     *
+     */
+    TEST_CASE("chess::TranspositionTable") {
+        TranspositionTable table;
+        CHECK(table.empty());
+        CHECK(!table.probe(42).isValid());
+
+        // sized to a power of two number of 64 byte buckets
+        table.resize(1);
+        CHECK(table.size() == (1024 * 1024 / 64) * TranspositionTable::BucketSize);
+
+        Move const move(4, 6, 4, 4, 0);
+        table.store(42, move, -1234, 3, TTEntry::Lower);
+        TTEntry entry = table.probe(42);
+        CHECK(entry.isValid());
+        CHECK(Move(entry.move) == move);
+        CHECK(entry.score == -1234);
+        CHECK(entry.depth == 3);
+        CHECK(entry.bound == TTEntry::Lower);
+        CHECK(!table.probe(43).isValid());
+
+        // negative depths and mate scores survive being packed
+        table.store(43, Move(), MIN_VALUE + 99, -2, TTEntry::Exact);
+        entry = table.probe(43);
+        CHECK(entry.score == MIN_VALUE + 99);
+        CHECK(entry.depth == -2);
+        CHECK(!Move(entry.move).isValid());
+
+        // a shallower inexact result doesn't replace a deeper one from the same search
+        table.store(42, move, 99, 1, TTEntry::Upper);
+        CHECK(table.probe(42).depth == 3);
+        table.store(42, move, 99, 1, TTEntry::Exact);
+        CHECK(table.probe(42).depth == 1);
+
+        // keys that share a bucket each get their own slot until the bucket is full
+        HashKey const stride = table.size() / TranspositionTable::BucketSize;
+        for (HashKey n = 1; n < TranspositionTable::BucketSize; n++) {
+            table.store(42 + n * stride, move, int(n), 5, TTEntry::Exact);
+        }
+        CHECK(table.probe(42).isValid());
+        for (HashKey n = 1; n < TranspositionTable::BucketSize; n++) {
+            CHECK(table.probe(42 + n * stride).score == int(n));
+        }
+
+        // then the shallowest entry makes way
+        table.store(42 + 9 * stride, move, 9, 5, TTEntry::Exact);
+        CHECK(!table.probe(42).isValid());
+        CHECK(table.probe(42 + 9 * stride).score == 9);
+
+        // entries from an older search make way first
+        table.newSearch();
+        table.store(42 + 9 * stride, move, 9, 5, TTEntry::Exact);
+        table.store(42 + 10 * stride, move, 10, 0, TTEntry::Exact);
+        CHECK(table.probe(42 + 10 * stride).isValid());
+        CHECK(table.probe(42 + 9 * stride).isValid());
+        CHECK(!table.probe(42 + 1 * stride).isValid());
+
+        TranspositionTable copy(table);
+        CHECK(copy.probe(42 + 10 * stride).score == 10);
+        table.clear();
+        CHECK(!table.probe(42 + 10 * stride).isValid());
+        CHECK(copy.probe(42 + 10 * stride).isValid());
+
+        // the counts kept by each thread add up to those of the whole table
+        TranspositionTable counted(1);
+        counted.store(42, move, 1, 1, TTEntry::Exact);
+        ThreadPool pool(2);
+        vector<future<bool>> probes;
+        for (int ndx = 0; ndx < 8; ndx++) {
+            probes.emplace_back(pool.submit([&counted]() {
+                return counted.probe(42).isValid() && !counted.probe(43).isValid();
+            }));
+        }
+        for (auto &found : probes) CHECK(found.get());
+        CHECK(counted.countProbes() == 16);
+        CHECK(counted.countHits() == 8);
+        CHECK(counted.countStores() == 1);
+        counted.clear();
+        CHECK(counted.countProbes() == 0);
+
+        // the search keeps the best move for the board it was asked about
+        Board game;
+        Minimax agent(1);
+
+        agent.useThreads = true;
+        agent.useCache = true;
+        agent.cacheSize = 1;
+        agent.timeout = 0;
+        agent.maxDepth = 2;
+        game.turn = White;
+
+        CHECK(agent.cache.empty());
+        game.generateMoveLists();
+        Move best = agent.bestMove(game);
+        CHECK(best.isValid(game));
+        CHECK(!agent.cache.empty());
+        entry = agent.cache.probe(game.getHash());
+        CHECK(entry.isValid());
+        CHECK(Move(entry.move) == best);
+        CHECK(entry.depth == agent.maxDepth + 1);
+
+        // and hands it back without searching again
+        CHECK(agent.bestMove(game) == best);
+        CHECK(agent.movesExamined == 0);
+    }
+}  // namespace chess